@@ -10,6 +10,7 @@
 #include "atom/browser/net/url_request_async_asar_job.h"
 #include "atom/browser/net/url_request_buffer_job.h"
 #include "atom/browser/net/url_request_fetch_job.h"
+#include "atom/browser/net/url_request_stream_job.h"
 #include "atom/browser/net/url_request_string_job.h"
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/value_converter.h"
@@ -152,6 +153,27 @@ Protocol::ProtocolError Protocol::UninterceptProtocolInIO(
           PROTOCOL_OK : PROTOCOL_NOT_INTERCEPTED;
 }
 
+// static
+bool Protocol::GetCacheSize(mate::Arguments* args,
+                            bool supported,
+                            size_t* cache_size) {
+  *cache_size = 0;
+  v8::Local<v8::Value> peek = args->PeekNext();
+  mate::Dictionary options;
+  double size = 0;
+  if (peek.IsEmpty() || peek->IsFunction() || !args->GetNext(&options) ||
+      !options.Get("cacheSize", &size))
+    return true;
+  if (!supported) {
+    args->ThrowError(
+        "cacheSize is only supported by buffer and string protocols");
+    return false;
+  }
+  if (size >= 1)
+    *cache_size = static_cast<size_t>(size);
+  return true;
+}
+
 void Protocol::OnIOCompleted(
     const CompletionCallback& callback, ProtocolError error) {
   // The completion callback is optional.
@@ -208,6 +230,8 @@ void Protocol::BuildPrototype(
                  &Protocol::RegisterProtocol<URLRequestAsyncAsarJob>)
       .SetMethod("registerHttpProtocol",
                  &Protocol::RegisterProtocol<URLRequestFetchJob>)
+      .SetMethod("registerStreamProtocol",
+                 &Protocol::RegisterProtocol<URLRequestStreamJob>)
       .SetMethod("unregisterProtocol", &Protocol::UnregisterProtocol)
       .SetMethod("isProtocolHandled", &Protocol::IsProtocolHandled)
       .SetMethod("interceptStringProtocol",
@@ -218,6 +242,8 @@ void Protocol::BuildPrototype(
                  &Protocol::InterceptProtocol<URLRequestAsyncAsarJob>)
       .SetMethod("interceptHttpProtocol",
                  &Protocol::InterceptProtocol<URLRequestFetchJob>)
+      .SetMethod("interceptStreamProtocol",
+                 &Protocol::InterceptProtocol<URLRequestStreamJob>)
       .SetMethod("uninterceptProtocol", &Protocol::UninterceptProtocol);
 }
 
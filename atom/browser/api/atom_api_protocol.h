@@ -12,6 +12,7 @@
 #include "atom/browser/api/trackable_object.h"
 #include "atom/browser/atom_browser_context.h"
 #include "atom/browser/net/atom_url_request_job_factory.h"
+#include "atom/browser/net/protocol_response_cache.h"
 #include "base/callback.h"
 #include "base/memory/weak_ptr.h"
 #include "content/public/browser/browser_thread.h"
@@ -69,10 +70,14 @@ class Protocol : public mate::TrackableObject<Protocol> {
     CustomProtocolHandler(
         v8::Isolate* isolate,
         net::URLRequestContextGetter* request_context,
-        const Handler& handler)
+        const Handler& handler,
+        size_t cache_size)
         : isolate_(isolate),
           request_context_(request_context),
-          handler_(handler) {}
+          handler_(handler) {
+      if (cache_size > 0)
+        response_cache_ = new ProtocolResponseCache(cache_size);
+    }
     ~CustomProtocolHandler() override {}
 
     net::URLRequestJob* MaybeCreateJob(
@@ -80,6 +85,8 @@ class Protocol : public mate::TrackableObject<Protocol> {
         net::NetworkDelegate* network_delegate) const override {
       RequestJob* request_job = new RequestJob(request, network_delegate);
       request_job->SetHandlerInfo(isolate_, request_context_.get(), handler_);
+      if (response_cache_)
+        request_job->SetResponseCache(response_cache_.get());
       return request_job;
     }
 
@@ -87,6 +94,8 @@ class Protocol : public mate::TrackableObject<Protocol> {
     v8::Isolate* isolate_;
     scoped_refptr<net::URLRequestContextGetter> request_context_;
     Protocol::Handler handler_;
+    // Shared with the jobs, which may outlive the handler.
+    scoped_refptr<ProtocolResponseCache> response_cache_;
 
     DISALLOW_COPY_AND_ASSIGN(CustomProtocolHandler);
   };
@@ -99,12 +108,16 @@ class Protocol : public mate::TrackableObject<Protocol> {
   void RegisterProtocol(const std::string& scheme,
                         const Handler& handler,
                         mate::Arguments* args) {
+    size_t cache_size;
+    if (!GetCacheSize(args, RequestJob::kSupportsResponseCache, &cache_size))
+      return;
     CompletionCallback callback;
     args->GetNext(&callback);
     content::BrowserThread::PostTaskAndReplyWithResult(
         content::BrowserThread::IO, FROM_HERE,
         base::Bind(&Protocol::RegisterProtocolInIO<RequestJob>,
-                   request_context_getter_, isolate(), scheme, handler),
+                   request_context_getter_, isolate(), scheme, handler,
+                   cache_size),
         base::Bind(&Protocol::OnIOCompleted,
                    GetWeakPtr(), callback));
   }
@@ -113,14 +126,15 @@ class Protocol : public mate::TrackableObject<Protocol> {
       scoped_refptr<brightray::URLRequestContextGetter> request_context_getter,
       v8::Isolate* isolate,
       const std::string& scheme,
-      const Handler& handler) {
+      const Handler& handler,
+      size_t cache_size) {
     auto job_factory = static_cast<AtomURLRequestJobFactory*>(
         request_context_getter->job_factory());
     if (job_factory->IsHandledProtocol(scheme))
       return PROTOCOL_REGISTERED;
     std::unique_ptr<CustomProtocolHandler<RequestJob>> protocol_handler(
         new CustomProtocolHandler<RequestJob>(
-            isolate, request_context_getter.get(), handler));
+            isolate, request_context_getter.get(), handler, cache_size));
     if (job_factory->SetProtocolHandler(scheme, std::move(protocol_handler)))
       return PROTOCOL_OK;
     else
@@ -145,12 +159,16 @@ class Protocol : public mate::TrackableObject<Protocol> {
   void InterceptProtocol(const std::string& scheme,
                          const Handler& handler,
                          mate::Arguments* args) {
+    size_t cache_size;
+    if (!GetCacheSize(args, RequestJob::kSupportsResponseCache, &cache_size))
+      return;
     CompletionCallback callback;
     args->GetNext(&callback);
     content::BrowserThread::PostTaskAndReplyWithResult(
         content::BrowserThread::IO, FROM_HERE,
         base::Bind(&Protocol::InterceptProtocolInIO<RequestJob>,
-                   request_context_getter_, isolate(), scheme, handler),
+                   request_context_getter_, isolate(), scheme, handler,
+                   cache_size),
         base::Bind(&Protocol::OnIOCompleted,
                    GetWeakPtr(), callback));
   }
@@ -159,7 +177,8 @@ class Protocol : public mate::TrackableObject<Protocol> {
       scoped_refptr<brightray::URLRequestContextGetter> request_context_getter,
       v8::Isolate* isolate,
       const std::string& scheme,
-      const Handler& handler) {
+      const Handler& handler,
+      size_t cache_size) {
     auto job_factory = static_cast<AtomURLRequestJobFactory*>(
         request_context_getter->job_factory());
     if (!job_factory->IsHandledProtocol(scheme))
@@ -169,7 +188,7 @@ class Protocol : public mate::TrackableObject<Protocol> {
       return PROTOCOL_FAIL;
     std::unique_ptr<CustomProtocolHandler<RequestJob>> protocol_handler(
         new CustomProtocolHandler<RequestJob>(
-            isolate, request_context_getter.get(), handler));
+            isolate, request_context_getter.get(), handler, cache_size));
     if (!job_factory->InterceptProtocol(scheme, std::move(protocol_handler)))
       return PROTOCOL_INTERCEPTED;
     return PROTOCOL_OK;
@@ -181,6 +200,13 @@ class Protocol : public mate::TrackableObject<Protocol> {
       scoped_refptr<brightray::URLRequestContextGetter> request_context_getter,
       const std::string& scheme);
 
+  // Reads the response cache budget from the optional options object passed
+  // before the completion callback, 0 when there should be no cache. Throws
+  // and returns false when the job type can not use a cache.
+  static bool GetCacheSize(mate::Arguments* args,
+                           bool supported,
+                           size_t* cache_size);
+
   // Convert error code to JS exception and call the callback.
   void OnIOCompleted(const CompletionCallback& callback, ProtocolError error);
 
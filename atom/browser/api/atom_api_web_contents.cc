@@ -4,12 +4,18 @@
 
 #include "atom/browser/api/atom_api_web_contents.h"
 
+#include <algorithm>
+#include <limits>
+#include <memory>
 #include <set>
 #include <string>
+#include <utility>
 
 #include "atom/browser/api/atom_api_debugger.h"
 #include "atom/browser/api/atom_api_session.h"
 #include "atom/browser/api/atom_api_window.h"
+#include "atom/browser/api/dirty_rect_packer.h"
+#include "atom/browser/api/paint_buffer_ring.h"
 #include "atom/browser/atom_browser_client.h"
 #include "atom/browser/atom_browser_context.h"
 #include "atom/browser/atom_browser_main_parts.h"
@@ -27,6 +33,8 @@
 #include "atom/browser/web_view_guest_delegate.h"
 #include "atom/common/api/api_messages.h"
 #include "atom/common/api/event_emitter_caller.h"
+#include "atom/common/api/locker.h"
+#include "atom/common/api/value_serializer.h"
 #include "atom/common/color_util.h"
 #include "atom/common/mouse_util.h"
 #include "atom/common/native_mate_converters/blink_converter.h"
@@ -40,6 +48,8 @@
 #include "atom/common/native_mate_converters/string16_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
 #include "atom/common/options_switches.h"
+#include "base/memory/shared_memory.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/threading/thread_task_runner_handle.h"
 #include "brightray/browser/inspectable_web_contents.h"
@@ -75,10 +85,12 @@
 #include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder.h"
 #include "net/url_request/url_request_context.h"
+#include "skia/ext/image_operations.h"
 #include "third_party/WebKit/public/platform/WebInputEvent.h"
 #include "third_party/WebKit/public/web/WebFindOptions.h"
 #include "ui/display/screen.h"
 #include "ui/events/base_event_utils.h"
+#include "ui/gfx/skia_util.h"
 
 #if !defined(OS_MACOSX)
 #include "ui/aura/window.h"
@@ -252,6 +264,141 @@ void OnCapturePageDone(const base::Callback<void(const gfx::Image&)>& callback,
   callback.Run(gfx::Image::CreateFrom1xBitmap(bitmap));
 }
 
+// The largest scale factor regions can be captured at, which bounds the size
+// of the readback.
+const float kMaxRegionScaleFactor = 4.0f;
+
+// Receives an image for each region, and whether the region was captured,
+// the image of a region with a buffer is always empty.
+using PageRegionsCallback =
+    base::Callback<void(const std::vector<gfx::Image>&,
+                        const std::vector<bool>&)>;
+
+// A batch of page regions captured with one readback of their union.
+struct PageRegionCapture {
+  struct Region {
+    gfx::Rect rect;
+    float scale_factor;
+    // The pixels are written to the buffer instead of a new image when set.
+    v8::Global<v8::Object> buffer;
+  };
+
+  std::vector<Region> regions;
+  // The union of the regions, and the scale it is read back at.
+  gfx::Rect bounds;
+  float scale_factor;
+  PageRegionsCallback callback;
+};
+
+// By default, the requested bitmap size is the view size in screen
+// coordinates.  However, if there's more pixel detail available on the
+// current system, increase the requested bitmap size to capture it all.
+float GetCaptureScaleFactor(content::RenderWidgetHostView* view) {
+  const float scale =
+      display::Screen::GetScreen()->GetDisplayNearestWindow(
+          view->GetNativeView()).device_scale_factor();
+  return std::max(scale, 1.0f);
+}
+
+// Cuts |region| out of the captured |bitmap| and scales it to the region's
+// scale factor. Only the part of the region inside the view is captured, the
+// image is cut to it and the rest of the buffer is cleared. Returns false when
+// nothing was captured.
+bool SliceCapturedRegion(v8::Isolate* isolate,
+                         const SkBitmap& bitmap,
+                         const PageRegionCapture& capture,
+                         const PageRegionCapture::Region& region,
+                         gfx::Image* image) {
+  gfx::Rect visible = region.rect;
+  visible.Intersect(capture.bounds);
+  const gfx::Size size = gfx::ScaleToCeiledSize(region.rect.size(),
+                                                region.scale_factor);
+  // Where the visible part lands in the pixels of the whole region.
+  gfx::Rect dest = gfx::ScaleToEnclosingRect(
+      visible - region.rect.OffsetFromOrigin(), region.scale_factor);
+  dest.Intersect(gfx::Rect(size));
+  gfx::Rect source = gfx::ScaleToEnclosingRect(
+      visible - capture.bounds.OffsetFromOrigin(), capture.scale_factor);
+  source.Intersect(gfx::Rect(bitmap.width(), bitmap.height()));
+  SkBitmap subset;
+  if (dest.IsEmpty() || source.IsEmpty() ||
+      !bitmap.extractSubset(&subset, gfx::RectToSkIRect(source)))
+    return false;
+  if (source.size() != dest.size()) {
+    subset = skia::ImageOperations::Resize(
+        subset, skia::ImageOperations::RESIZE_GOOD,
+        dest.width(), dest.height());
+  }
+
+  if (!region.buffer.IsEmpty()) {
+    v8::Local<v8::Object> buffer =
+        v8::Local<v8::Object>::New(isolate, region.buffer);
+    char* data = node::Buffer::Data(buffer);
+    const size_t row_bytes = static_cast<size_t>(size.width()) * 4;
+    if (!subset.readPixels(
+            SkImageInfo::MakeN32Premul(dest.width(), dest.height()),
+            data + dest.y() * row_bytes + dest.x() * 4, row_bytes, 0, 0))
+      return false;
+    // Clear what is outside the view, instead of leaving stale pixels.
+    for (int y = 0; y < size.height(); ++y) {
+      char* row = data + y * row_bytes;
+      if (y < dest.y() || y >= dest.bottom()) {
+        memset(row, 0, row_bytes);
+      } else {
+        memset(row, 0, dest.x() * 4);
+        memset(row + dest.right() * 4, 0, (size.width() - dest.right()) * 4);
+      }
+    }
+    return true;
+  }
+
+  // Copy the slice so the image does not keep the whole capture alive.
+  SkBitmap copy;
+  if (!subset.copyTo(&copy))
+    return false;
+  *image = gfx::Image::CreateFrom1xBitmap(copy);
+  return true;
+}
+
+// Called when the union of CapturePageRegions is read back.
+void OnCapturePageRegionsDone(v8::Isolate* isolate,
+                              std::unique_ptr<PageRegionCapture> capture,
+                              const SkBitmap& bitmap,
+                              content::ReadbackResponse response) {
+  std::vector<gfx::Image> images(capture->regions.size());
+  std::vector<bool> captured(capture->regions.size());
+  if (response == content::READBACK_SUCCESS) {
+    mate::Locker locker(isolate);
+    v8::HandleScope handle_scope(isolate);
+    for (size_t i = 0; i < capture->regions.size(); ++i)
+      captured[i] = SliceCapturedRegion(isolate, bitmap, *capture,
+                                        capture->regions[i], &images[i]);
+  }
+  capture->callback.Run(images, captured);
+}
+
+// Unmaps the shared memory backing a Buffer when it is garbage collected.
+void FreeSharedMemory(char* data, void* hint) {
+  delete static_cast<base::SharedMemory*>(hint);
+}
+
+// Whether |size| bytes of the region behind |handle| can be mapped, the size
+// is claimed by the renderer and can not be trusted.
+bool IsValidSharedMemorySize(const base::SharedMemoryHandle& handle,
+                             uint32_t size) {
+  if (size == 0)
+    return false;
+#if defined(OS_POSIX)
+  size_t region_size;
+  return base::SharedMemory::GetSizeFromSharedMemoryHandle(handle,
+                                                           &region_size) &&
+         size <= region_size;
+#else
+  // MapViewOfFile refuses views larger than the section.
+  return true;
+#endif
+}
+
 // Set the background color of RenderWidgetHostView.
 void SetBackgroundColor(content::WebContents* web_contents) {
   const auto view = web_contents->GetRenderWidgetHostView();
@@ -308,13 +455,15 @@ WebContents::WebContents(v8::Isolate* isolate, const mate::Dictionary& options)
   // and Electron will soon crash.
   // Remvoe this after we upgraded to use VS 2015 Update 3.
   bool b = false;
+  mate::Dictionary offscreen_options;
   if (options.Get("isGuest", &b) && b)
     type_ = WEB_VIEW;
   else if (options.Get("isBackgroundPage", &b) && b)
     type_ = BACKGROUND_PAGE;
   else if (options.Get("isBrowserView", &b) && b)
     type_ = BROWSER_VIEW;
-  else if (options.Get("offscreen", &b) && b)
+  else if ((options.Get("offscreen", &b) && b) ||
+           options.Get("offscreen", &offscreen_options))
     type_ = OFF_SCREEN;
 
   // Init embedder earlier
@@ -360,6 +509,29 @@ WebContents::WebContents(v8::Isolate* isolate, const mate::Dictionary& options)
     bool transparent = false;
     options.Get("transparent", &transparent);
 
+    // How frames are delivered, the options are exclusive.
+    if (!offscreen_options.IsEmpty()) {
+      mate::Dictionary encoder_options;
+      bool dirty_rects = false;
+      int shared_buffers = 0;
+      if (offscreen_options.Get("encoder", &encoder_options)) {
+        std::string error;
+        // The options are checked before construction where they can be
+        // rejected, so only warn when they still get here.
+        frame_encoder_ = FrameEncoder::Create(encoder_options, &error);
+        if (!frame_encoder_)
+          LOG(WARNING) << "Offscreen frames are not encoded: " << error;
+      } else if (offscreen_options.Get("dirtyRects", &dirty_rects) &&
+                 dirty_rects) {
+        double merge_threshold = 0.25;
+        offscreen_options.Get("mergeThreshold", &merge_threshold);
+        dirty_rect_packer_.reset(new DirtyRectPacker(merge_threshold));
+      } else if (offscreen_options.Get("sharedBuffers", &shared_buffers) &&
+                 shared_buffers > 0) {
+        paint_buffer_ring_.reset(new PaintBufferRing(isolate, shared_buffers));
+      }
+    }
+
     content::WebContents::CreateParams params(session->browser_context());
     auto* view = new OffScreenWebContentsView(
         transparent, base::Bind(&WebContents::OnPaint, base::Unretained(this)));
@@ -939,6 +1111,11 @@ bool WebContents::OnMessageReceived(const IPC::Message& message) {
   bool handled = true;
   IPC_BEGIN_MESSAGE_MAP(WebContents, message)
     IPC_MESSAGE_HANDLER(AtomViewHostMsg_Message, OnRendererMessage)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_Message_Serialized,
+                        OnRendererMessageSerialized)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_Message_SharedMemory,
+                        OnRendererMessageSharedMemory)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_Invoke, OnRendererInvoke)
     IPC_MESSAGE_HANDLER_DELAY_REPLY(AtomViewHostMsg_Message_Sync,
                                     OnRendererMessageSync)
     IPC_MESSAGE_HANDLER_DELAY_REPLY(AtomViewHostMsg_SetTemporaryZoomLevel,
@@ -1417,6 +1594,51 @@ bool WebContents::SendIPCMessage(bool all_frames,
   return Send(new AtomViewMsg_Message(routing_id(), all_frames, channel, args));
 }
 
+bool WebContents::SendInvokeReply(int frame_routing_id,
+                                  v8::Local<v8::Value> reply,
+                                  mate::Arguments* args) {
+  // The DataCloneError thrown by the serializer is left to the caller.
+  std::vector<uint8_t> payload;
+  if (!SerializeV8Value(args->isolate(), reply, &payload))
+    return false;
+  return Send(new AtomViewMsg_InvokeReply(routing_id(), frame_routing_id,
+                                          payload));
+}
+
+bool WebContents::SendSharedMemory(const base::string16& channel,
+                                   v8::Local<v8::Value> buffer,
+                                   mate::Arguments* args) {
+  if (!buffer->IsArrayBufferView()) {
+    args->ThrowError("Buffer must be an ArrayBufferView");
+    return false;
+  }
+
+  auto view = v8::Local<v8::ArrayBufferView>::Cast(buffer);
+  size_t size = view->ByteLength();
+  if (size == 0 || size > std::numeric_limits<uint32_t>::max()) {
+    args->ThrowError("Invalid buffer size");
+    return false;
+  }
+
+  base::ProcessHandle process =
+      web_contents()->GetRenderProcessHost()->GetHandle();
+  if (process == base::kNullProcessHandle)
+    return false;
+
+  base::SharedMemory shared_memory;
+  if (!shared_memory.CreateAndMapAnonymous(size)) {
+    args->ThrowError("Unable to allocate shared memory");
+    return false;
+  }
+  view->CopyContents(shared_memory.memory(), size);
+
+  base::SharedMemoryHandle handle;
+  if (!shared_memory.ShareToProcess(process, &handle))
+    return false;
+  return Send(new AtomViewMsg_Message_SharedMemory(
+      routing_id(), channel, handle, static_cast<uint32_t>(size)));
+}
+
 void WebContents::SendInputEvent(v8::Isolate* isolate,
                                  v8::Local<v8::Value> input_event) {
   const auto view = static_cast<content::RenderWidgetHostViewBase*>(
@@ -1454,9 +1676,37 @@ void WebContents::SendInputEvent(v8::Isolate* isolate,
 
 void WebContents::BeginFrameSubscription(mate::Arguments* args) {
   bool only_dirty = false;
+  FrameSubscriber::Format format = FrameSubscriber::Format::BGRA;
+  mate::Dictionary options;
+  std::unique_ptr<FrameEncoder> encoder;
   FrameSubscriber::FrameCaptureCallback callback;
 
-  args->GetNext(&only_dirty);
+  if (!args->GetNext(&only_dirty) && args->Length() == 2 &&
+      args->GetNext(&options)) {
+    options.Get("onlyDirty", &only_dirty);
+    std::string format_name;
+    if (options.Get("format", &format_name)) {
+      if (format_name == "i420") {
+        format = FrameSubscriber::Format::I420;
+      } else if (format_name != "bgra") {
+        args->ThrowError("Unknown frame format: " + format_name);
+        return;
+      }
+    }
+    mate::Dictionary encoder_options;
+    if (options.Get("encoder", &encoder_options)) {
+      if (format != FrameSubscriber::Format::BGRA) {
+        args->ThrowError("encoder can only be used with the bgra format");
+        return;
+      }
+      std::string error;
+      encoder = FrameEncoder::Create(encoder_options, &error);
+      if (!encoder) {
+        args->ThrowError(error);
+        return;
+      }
+    }
+  }
   if (!args->GetNext(&callback)) {
     args->ThrowError();
     return;
@@ -1465,7 +1715,7 @@ void WebContents::BeginFrameSubscription(mate::Arguments* args) {
   const auto view = web_contents()->GetRenderWidgetHostView();
   if (view) {
     std::unique_ptr<FrameSubscriber> frame_subscriber(new FrameSubscriber(
-        isolate(), view, callback, only_dirty));
+        isolate(), view, callback, only_dirty, format, std::move(encoder)));
     view->BeginFrameSubscription(std::move(frame_subscriber));
   }
 }
@@ -1533,17 +1783,8 @@ void WebContents::CapturePage(mate::Arguments* args) {
   // Capture full page if user doesn't specify a |rect|.
   const gfx::Size view_size = rect.IsEmpty() ? view->GetViewBounds().size() :
                                                rect.size();
-
-  // By default, the requested bitmap size is the view size in screen
-  // coordinates.  However, if there's more pixel detail available on the
-  // current system, increase the requested bitmap size to capture it all.
-  gfx::Size bitmap_size = view_size;
-  const gfx::NativeView native_view = view->GetNativeView();
-  const float scale =
-      display::Screen::GetScreen()->GetDisplayNearestWindow(native_view)
-      .device_scale_factor();
-  if (scale > 1.0f)
-    bitmap_size = gfx::ScaleToCeiledSize(view_size, scale);
+  const gfx::Size bitmap_size =
+      gfx::ScaleToCeiledSize(view_size, GetCaptureScaleFactor(view));
 
   view->CopyFromSurface(gfx::Rect(rect.origin(), view_size),
                         bitmap_size,
@@ -1551,6 +1792,75 @@ void WebContents::CapturePage(mate::Arguments* args) {
                         kBGRA_8888_SkColorType);
 }
 
+void WebContents::CapturePageRegions(mate::Arguments* args) {
+  std::vector<mate::Dictionary> regions;
+  PageRegionsCallback callback;
+  if (!args->GetNext(&regions) || !args->GetNext(&callback)) {
+    args->ThrowError();
+    return;
+  }
+
+  const auto view = web_contents()->GetRenderWidgetHostView();
+  const float default_scale = view ? GetCaptureScaleFactor(view) : 1.0f;
+  const gfx::Rect view_bounds =
+      view ? gfx::Rect(view->GetViewBounds().size()) : gfx::Rect();
+
+  std::unique_ptr<PageRegionCapture> capture(new PageRegionCapture);
+  capture->scale_factor = 0;
+  capture->callback = callback;
+  for (size_t i = 0; i < regions.size(); ++i) {
+    const std::string index = base::SizeTToString(i);
+    PageRegionCapture::Region region;
+    region.scale_factor = default_scale;
+    if (!mate::ConvertFromV8(isolate(), regions[i].GetHandle(),
+                             &region.rect) ||
+        (regions[i].Get("scaleFactor", &region.scale_factor) &&
+         !(region.scale_factor > 0 &&
+           region.scale_factor <= kMaxRegionScaleFactor))) {
+      args->ThrowError("Invalid region at index " + index);
+      return;
+    }
+
+    v8::Local<v8::Value> buffer;
+    if (regions[i].Get("buffer", &buffer) && !buffer->IsUndefined()) {
+      gfx::Size size = gfx::ScaleToCeiledSize(region.rect.size(),
+                                              region.scale_factor);
+      if (!node::Buffer::HasInstance(buffer) ||
+          node::Buffer::Length(buffer) <
+              static_cast<size_t>(size.GetArea()) * 4) {
+        args->ThrowError("The buffer of region " + index + " is too small");
+        return;
+      }
+      region.buffer.Reset(isolate(), buffer.As<v8::Object>());
+    }
+
+    gfx::Rect bounds = region.rect;
+    bounds.Intersect(view_bounds);
+    if (!bounds.IsEmpty()) {
+      capture->bounds.Union(bounds);
+      capture->scale_factor =
+          std::max(capture->scale_factor, region.scale_factor);
+    }
+    capture->regions.push_back(std::move(region));
+  }
+
+  if (capture->bounds.IsEmpty()) {
+    callback.Run(std::vector<gfx::Image>(regions.size()),
+                 std::vector<bool>(regions.size()));
+    return;
+  }
+
+  // Read back the union once at the largest scale, and slice it when done.
+  const gfx::Rect bounds = capture->bounds;
+  const gfx::Size bitmap_size =
+      gfx::ScaleToCeiledSize(bounds.size(), capture->scale_factor);
+  view->CopyFromSurface(bounds,
+                        bitmap_size,
+                        base::Bind(&OnCapturePageRegionsDone, isolate(),
+                                   base::Passed(&capture)),
+                        kBGRA_8888_SkColorType);
+}
+
 void WebContents::OnCursorChange(const content::WebCursor& cursor) {
   content::WebCursor::CursorInfo info;
   cursor.GetCursorInfo(&info);
@@ -1580,7 +1890,87 @@ bool WebContents::IsOffScreen() const {
 }
 
 void WebContents::OnPaint(const gfx::Rect& dirty_rect, const SkBitmap& bitmap) {
-  Emit("paint", dirty_rect, gfx::Image::CreateFrom1xBitmap(bitmap));
+  if (frame_encoder_) {
+    if (!frame_encoder_->Encode(bitmap, dirty_rect, base::TimeTicks::Now(),
+                                base::Bind(&WebContents::OnPaintEncoded,
+                                           base::Unretained(this))))
+      OnPaintRejected();
+    return;
+  }
+  if (dirty_rect_packer_) {
+    OnPaintDirtyRects(dirty_rect, bitmap);
+    return;
+  }
+  if (!paint_buffer_ring_) {
+    Emit("paint", dirty_rect, gfx::Image::CreateFrom1xBitmap(bitmap));
+    return;
+  }
+
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  int index;
+  gfx::Rect rect;
+  // Frames are dropped while JS holds all buffers.
+  if (!paint_buffer_ring_->Write(dirty_rect, bitmap, &index, &rect)) {
+    OnPaintRejected();
+    return;
+  }
+
+  mate::Dictionary frame = mate::Dictionary::CreateEmpty(isolate());
+  frame.Set("index", index);
+  frame.Set("buffer", paint_buffer_ring_->GetArrayBuffer(index));
+  frame.Set("size", paint_buffer_ring_->size());
+  frame.Set("stride", paint_buffer_ring_->stride());
+  Emit("paint", rect, frame);
+}
+
+void WebContents::OnPaintDirtyRects(const gfx::Rect& dirty_rect,
+                                    const SkBitmap& bitmap) {
+  std::vector<gfx::Rect> rects;
+  dirty_rect_packer_->Update(dirty_rect, bitmap, &rects);
+  if (rects.empty())
+    return;
+
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  gfx::Rect bounds;
+  std::vector<mate::Dictionary> payloads;
+  for (const gfx::Rect& rect : rects) {
+    bounds.Union(rect);
+    v8::Local<v8::Object> data;
+    size_t length = static_cast<size_t>(rect.width()) * rect.height() * 4;
+    if (!node::Buffer::New(isolate(), length).ToLocal(&data))
+      return;
+    DirtyRectPacker::CopyRect(
+        bitmap, rect, reinterpret_cast<uint8_t*>(node::Buffer::Data(data)));
+
+    mate::Dictionary payload = mate::Dictionary::CreateEmpty(isolate());
+    payload.Set("rect", rect);
+    payload.Set("stride", rect.width() * 4);
+    payload.Set("data", data);
+    payloads.push_back(payload);
+  }
+  Emit("paint", bounds, payloads);
+}
+
+void WebContents::OnPaintEncoded(std::unique_ptr<FrameEncoder::Frame> frame) {
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  gfx::Rect dirty_rect = frame->dirty_rect;
+  Emit("paint", dirty_rect,
+       FrameEncoder::FrameToDictionary(isolate(), std::move(frame)));
+}
+
+void WebContents::OnPaintRejected() {
+  auto* osr_rwhv = static_cast<OffScreenRenderWidgetHostView*>(
+      web_contents()->GetRenderWidgetHostView());
+  if (osr_rwhv)
+    osr_rwhv->OnPaintRejected();
+}
+
+void WebContents::ReleasePaintBuffer(int index) {
+  if (paint_buffer_ring_)
+    paint_buffer_ring_->Release(index);
 }
 
 void WebContents::StartPainting() {
@@ -1631,6 +2021,23 @@ int WebContents::GetFrameRate() const {
   return osr_rwhv ? osr_rwhv->GetFrameRate() : 0;
 }
 
+v8::Local<v8::Value> WebContents::GetFrameStats() const {
+  if (!IsOffScreen())
+    return v8::Null(isolate());
+
+  const auto* osr_rwhv = static_cast<OffScreenRenderWidgetHostView*>(
+      web_contents()->GetRenderWidgetHostView());
+  OffScreenFrameStats stats;
+  if (osr_rwhv)
+    stats = osr_rwhv->GetFrameStats();
+
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate());
+  dict.Set("droppedFrames", static_cast<double>(stats.dropped_frames));
+  dict.Set("coalescedFrames", static_cast<double>(stats.coalesced_frames));
+  dict.Set("frameRate", stats.frame_rate);
+  return dict.GetHandle();
+}
+
 void WebContents::Invalidate() {
   if (IsOffScreen()) {
     auto* osr_rwhv = static_cast<OffScreenRenderWidgetHostView*>(
@@ -1789,6 +2196,8 @@ void WebContents::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("isFocused", &WebContents::IsFocused)
       .SetMethod("tabTraverse", &WebContents::TabTraverse)
       .SetMethod("_send", &WebContents::SendIPCMessage)
+      .SetMethod("_sendSharedMemory", &WebContents::SendSharedMemory)
+      .SetMethod("_sendInvokeReply", &WebContents::SendInvokeReply)
       .SetMethod("sendInputEvent", &WebContents::SendInputEvent)
       .SetMethod("beginFrameSubscription",
                  &WebContents::BeginFrameSubscription)
@@ -1802,7 +2211,9 @@ void WebContents::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("isPainting", &WebContents::IsPainting)
       .SetMethod("setFrameRate", &WebContents::SetFrameRate)
       .SetMethod("getFrameRate", &WebContents::GetFrameRate)
+      .SetMethod("getFrameStats", &WebContents::GetFrameStats)
       .SetMethod("invalidate", &WebContents::Invalidate)
+      .SetMethod("releasePaintBuffer", &WebContents::ReleasePaintBuffer)
       .SetMethod("setZoomLevel", &WebContents::SetZoomLevel)
       .SetMethod("_getZoomLevel", &WebContents::GetZoomLevel)
       .SetMethod("setZoomFactor", &WebContents::SetZoomFactor)
@@ -1822,6 +2233,7 @@ void WebContents::BuildPrototype(v8::Isolate* isolate,
                  &WebContents::ShowDefinitionForSelection)
       .SetMethod("copyImageAt", &WebContents::CopyImageAt)
       .SetMethod("capturePage", &WebContents::CapturePage)
+      .SetMethod("_capturePageRegions", &WebContents::CapturePageRegions)
       .SetMethod("setEmbedder", &WebContents::SetEmbedder)
       .SetMethod("setWebRTCIPHandlingPolicy",
                  &WebContents::SetWebRTCIPHandlingPolicy)
@@ -1844,6 +2256,64 @@ void WebContents::OnRendererMessage(const base::string16& channel,
   Emit(base::UTF16ToUTF8(channel), args);
 }
 
+void WebContents::OnRendererMessageSerialized(
+    const base::string16& channel, const std::vector<uint8_t>& payload) {
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  v8::Local<v8::Value> args;
+  if (!DeserializeV8Value(isolate(), payload).ToLocal(&args) ||
+      !args->IsArray()) {
+    LOG(ERROR) << "Failed to deserialize message on " << channel;
+    return;
+  }
+  // webContents.emit(channel, new Event(), args...);
+  Emit(base::UTF16ToUTF8(channel), args);
+}
+
+void WebContents::OnRendererInvoke(int frame_routing_id,
+                                   const std::vector<uint8_t>& payload) {
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  v8::Local<v8::Value> args;
+  if (!DeserializeV8Value(isolate(), payload).ToLocal(&args) ||
+      !args->IsArray()) {
+    LOG(ERROR) << "Failed to deserialize invoke request";
+    return;
+  }
+  // webContents.emit('ipc-invoke', new Event(), frameRoutingId, args);
+  Emit("ipc-invoke", frame_routing_id, args);
+}
+
+void WebContents::OnRendererMessageSharedMemory(
+    const base::string16& channel,
+    const base::SharedMemoryHandle& handle,
+    uint32_t size) {
+  std::unique_ptr<base::SharedMemory> shared_memory(
+      new base::SharedMemory(handle, false));
+  if (!IsValidSharedMemorySize(handle, size) || !shared_memory->Map(size)) {
+    web_contents()->GetRenderProcessHost()->ShutdownForBadMessage(
+        content::RenderProcessHost::CrashReportMode::GENERATE_CRASH_DUMP);
+    return;
+  }
+
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  // The Buffer owns the mapping, so the data is never copied.
+  v8::Local<v8::Object> buffer;
+  if (!node::Buffer::New(isolate(),
+                         static_cast<char*>(shared_memory->memory()), size,
+                         &FreeSharedMemory, shared_memory.get())
+           .ToLocal(&buffer))
+    return;
+  shared_memory.release();
+
+  // webContents.emit('ipc-message', new Event(), [channel, buffer]);
+  std::vector<v8::Local<v8::Value>> args = {
+    mate::ConvertToV8(isolate(), channel), buffer
+  };
+  Emit("ipc-message", args);
+}
+
 void WebContents::OnRendererMessageSync(const base::string16& channel,
                                         const base::ListValue& args,
                                         IPC::Message* message) {
@@ -1877,6 +2347,17 @@ mate::Handle<WebContents> WebContents::Create(
   return mate::CreateHandle(isolate, new WebContents(isolate, options));
 }
 
+// static
+bool WebContents::CheckOffscreenOptions(const mate::Dictionary& options,
+                                        std::string* error) {
+  mate::Dictionary offscreen_options;
+  mate::Dictionary encoder_options;
+  if (!options.Get("offscreen", &offscreen_options) ||
+      !offscreen_options.Get("encoder", &encoder_options))
+    return true;
+  return FrameEncoder::CheckOptions(encoder_options, error);
+}
+
 }  // namespace api
 
 }  // namespace atom
@@ -12,6 +12,7 @@
 #include "atom/browser/api/save_page_handler.h"
 #include "atom/browser/api/trackable_object.h"
 #include "atom/browser/common_web_contents_delegate.h"
+#include "base/memory/shared_memory_handle.h"
 #include "content/common/cursors/webcursor.h"
 #include "content/public/browser/notification_observer.h"
 #include "content/public/browser/notification_registrar.h"
@@ -46,6 +47,9 @@ class WebViewGuestDelegate;
 
 namespace api {
 
+class DirtyRectPacker;
+class PaintBufferRing;
+
 class WebContents : public mate::TrackableObject<WebContents>,
                     public CommonWebContentsDelegate,
                     public content::WebContentsObserver,
@@ -74,6 +78,11 @@ class WebContents : public mate::TrackableObject<WebContents>,
   static mate::Handle<WebContents> Create(
       v8::Isolate* isolate, const mate::Dictionary& options);
 
+  // Checks the offscreen options in the web preferences |options| before a
+  // WebContents is created with them, sets |error| when they are invalid.
+  static bool CheckOffscreenOptions(const mate::Dictionary& options,
+                                    std::string* error);
+
   static void BuildPrototype(v8::Isolate* isolate,
                              v8::Local<v8::FunctionTemplate> prototype);
 
@@ -156,6 +165,16 @@ class WebContents : public mate::TrackableObject<WebContents>,
                       const base::string16& channel,
                       const base::ListValue& args);
 
+  // Send the reply of ipcRenderer.invoke to the frame that made the request.
+  bool SendInvokeReply(int frame_routing_id,
+                       v8::Local<v8::Value> reply,
+                       mate::Arguments* args);
+
+  // Send a large buffer to the main frame through shared memory.
+  bool SendSharedMemory(const base::string16& channel,
+                        v8::Local<v8::Value> buffer,
+                        mate::Arguments* args);
+
   // Send WebInputEvent to the page.
   void SendInputEvent(v8::Isolate* isolate, v8::Local<v8::Value> input_event);
 
@@ -170,6 +189,9 @@ class WebContents : public mate::TrackableObject<WebContents>,
   // done.
   void CapturePage(mate::Arguments* args);
 
+  // Captures a list of regions with one readback of their union.
+  void CapturePageRegions(mate::Arguments* args);
+
   // Methods for creating <webview>.
   void SetSize(const SetSizeParams& params);
   bool IsGuest() const;
@@ -177,11 +199,13 @@ class WebContents : public mate::TrackableObject<WebContents>,
   // Methods for offscreen rendering
   bool IsOffScreen() const;
   void OnPaint(const gfx::Rect& dirty_rect, const SkBitmap& bitmap);
+  void ReleasePaintBuffer(int index);
   void StartPainting();
   void StopPainting();
   bool IsPainting() const;
   void SetFrameRate(int frame_rate);
   int GetFrameRate() const;
+  v8::Local<v8::Value> GetFrameStats() const;
   void Invalidate();
 
   // Methods for zoom handling.
@@ -367,10 +391,33 @@ class WebContents : public mate::TrackableObject<WebContents>,
   // Called when we receive a CursorChange message from chromium.
   void OnCursorChange(const content::WebCursor& cursor);
 
+  // Emits the changed parts of an offscreen frame.
+  void OnPaintDirtyRects(const gfx::Rect& dirty_rect, const SkBitmap& bitmap);
+
+  // Emits an offscreen frame compressed by |frame_encoder_|.
+  void OnPaintEncoded(std::unique_ptr<FrameEncoder::Frame> frame);
+
+  // Tells the offscreen view that a frame was dropped by the paint handler.
+  void OnPaintRejected();
+
   // Called when received a message from renderer.
   void OnRendererMessage(const base::string16& channel,
                          const base::ListValue& args);
 
+  // Called when received a message serialized with v8::ValueSerializer from
+  // renderer.
+  void OnRendererMessageSerialized(const base::string16& channel,
+                                   const std::vector<uint8_t>& payload);
+
+  // Called when received a request of ipcRenderer.invoke from renderer.
+  void OnRendererInvoke(int frame_routing_id,
+                        const std::vector<uint8_t>& payload);
+
+  // Called when received a buffer in shared memory from renderer.
+  void OnRendererMessageSharedMemory(const base::string16& channel,
+                                     const base::SharedMemoryHandle& handle,
+                                     uint32_t size);
+
   // Called when received a synchronous message from renderer.
   void OnRendererMessageSync(const base::string16& channel,
                              const base::ListValue& args,
@@ -390,6 +437,18 @@ class WebContents : public mate::TrackableObject<WebContents>,
 
   std::unique_ptr<WebViewGuestDelegate> guest_delegate_;
 
+  // Persistent buffers offscreen frames are delivered in, when enabled with
+  // the "sharedBuffers" offscreen option.
+  std::unique_ptr<PaintBufferRing> paint_buffer_ring_;
+
+  // Finds the changed parts of offscreen frames, when enabled with the
+  // "dirtyRects" offscreen option.
+  std::unique_ptr<DirtyRectPacker> dirty_rect_packer_;
+
+  // Compresses offscreen frames, when enabled with the "encoder" offscreen
+  // option.
+  std::unique_ptr<FrameEncoder> frame_encoder_;
+
   // The host webcontents that may contain this webcontents.
   WebContents* embedder_;
 
@@ -5,15 +5,20 @@
 #include "atom/browser/api/atom_api_web_request.h"
 
 #include <string>
+#include <vector>
 
 #include "atom/browser/atom_browser_context.h"
 #include "atom/browser/net/atom_network_delegate.h"
+#include "atom/browser/net/web_request_rules.h"
 #include "atom/common/native_mate_converters/callback.h"
+#include "atom/common/native_mate_converters/gurl_converter.h"
 #include "atom/common/native_mate_converters/net_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
+#include "base/strings/string_number_conversions.h"
 #include "content/public/browser/browser_thread.h"
 #include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder.h"
+#include "net/http/http_util.h"
 
 using content::BrowserThread;
 
@@ -31,12 +36,128 @@ struct Converter<URLPattern> {
   }
 };
 
+template<>
+struct Converter<atom::AtomNetworkDelegate::ListenerDetails> {
+  static v8::Local<v8::Value> ToV8(
+      v8::Isolate* isolate,
+      const atom::AtomNetworkDelegate::ListenerDetails& val) {
+    v8::Local<v8::Value> details = ConvertToV8(isolate, *val.dict);
+    if (val.upload_data && details->IsObject()) {
+      Dictionary(isolate, details.As<v8::Object>()).Set(
+          "uploadData", val.upload_data);
+    }
+    return details;
+  }
+};
+
 }  // namespace mate
 
 namespace atom {
 
 namespace api {
 
+namespace {
+
+using Action = WebRequestRules::Action;
+
+struct ActionName {
+  const char* name;
+  Action action;
+};
+
+const ActionName kActionNames[] = {
+  { "block", Action::BLOCK },
+  { "redirect", Action::REDIRECT },
+  { "upgradeScheme", Action::UPGRADE_SCHEME },
+  { "setRequestHeader", Action::SET_REQUEST_HEADER },
+  { "removeRequestHeader", Action::REMOVE_REQUEST_HEADER },
+  { "setResponseHeader", Action::SET_RESPONSE_HEADER },
+  { "removeResponseHeader", Action::REMOVE_RESPONSE_HEADER },
+};
+
+// Reads a rule from |dict|, sets |error| when it is invalid.
+bool ParseRule(const mate::Dictionary& dict,
+               WebRequestRules::Rule* rule,
+               std::string* error) {
+  std::string action;
+  dict.Get("action", &action);
+  bool found = false;
+  for (const ActionName& name : kActionNames) {
+    if (action == name.name) {
+      rule->action = name.action;
+      found = true;
+      break;
+    }
+  }
+  if (!found) {
+    *error = "Unknown action: " + action;
+    return false;
+  }
+
+  v8::Local<v8::Value> value;
+  if (dict.Get("urls", &value) &&
+      !mate::ConvertFromV8(dict.isolate(), value, &rule->url_patterns)) {
+    *error = "Invalid URL patterns";
+    return false;
+  }
+  if (dict.Get("resourceTypes", &value) &&
+      !mate::ConvertFromV8(dict.isolate(), value, &rule->resource_types)) {
+    *error = "Invalid resource types";
+    return false;
+  }
+
+  switch (rule->action) {
+    case Action::REDIRECT:
+      if (!dict.Get("redirectURL", &rule->redirect_url) ||
+          !rule->redirect_url.is_valid()) {
+        *error = "redirectURL must be a valid URL";
+        return false;
+      }
+      break;
+    case Action::SET_REQUEST_HEADER:
+    case Action::SET_RESPONSE_HEADER:
+      if (!dict.Get("value", &rule->header_value) ||
+          !net::HttpUtil::IsValidHeaderValue(rule->header_value)) {
+        *error = "value must be a valid header value";
+        return false;
+      }
+      // Fall through.
+    case Action::REMOVE_REQUEST_HEADER:
+    case Action::REMOVE_RESPONSE_HEADER:
+      if (!dict.Get("name", &rule->header_name) ||
+          !net::HttpUtil::IsValidHeaderName(rule->header_name)) {
+        *error = "name must be a valid header name";
+        return false;
+      }
+      break;
+    default:
+      break;
+  }
+  return true;
+}
+
+// Reads the mask of optional details fields from their |names|.
+bool ParseDetailsFields(const std::vector<std::string>& names,
+                        int* fields,
+                        std::string* error) {
+  *fields = 0;
+  for (const std::string& name : names) {
+    if (name == "uploadData") {
+      *fields |= AtomNetworkDelegate::kUploadData;
+    } else if (name == "requestHeaders") {
+      *fields |= AtomNetworkDelegate::kRequestHeaders;
+    } else if (name == "responseHeaders") {
+      *fields |= AtomNetworkDelegate::kResponseHeaders;
+    } else {
+      *error = "Unknown details field: " + name;
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
 WebRequest::WebRequest(v8::Isolate* isolate,
                        AtomBrowserContext* browser_context)
     : browser_context_(browser_context) {
@@ -60,10 +181,21 @@ void WebRequest::SetResponseListener(mate::Arguments* args) {
 
 template<typename Listener, typename Method, typename Event>
 void WebRequest::SetListener(Method method, Event type, mate::Arguments* args) {
-  // { urls }.
+  // { urls, fields }.
   URLPatterns patterns;
+  int fields = AtomNetworkDelegate::kAllDetailsFields;
   mate::Dictionary dict;
-  args->GetNext(&dict) && dict.Get("urls", &patterns);
+  if (args->GetNext(&dict)) {
+    dict.Get("urls", &patterns);
+    std::vector<std::string> names;
+    if (dict.Get("fields", &names)) {
+      std::string error;
+      if (!ParseDetailsFields(names, &fields, &error)) {
+        args->ThrowError(error);
+        return;
+      }
+    }
+  }
 
   // Function or null.
   v8::Local<v8::Value> value;
@@ -77,7 +209,35 @@ void WebRequest::SetListener(Method method, Event type, mate::Arguments* args) {
   auto delegate = browser_context_->network_delegate();
   BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
                           base::Bind(method, base::Unretained(delegate), type,
-                                     patterns, listener));
+                                     patterns, fields, listener));
+}
+
+void WebRequest::SetRules(mate::Arguments* args) {
+  // Array of rules, or null.
+  std::vector<mate::Dictionary> dicts;
+  v8::Local<v8::Value> value;
+  if (!args->GetNext(&dicts) &&
+      !(args->GetNext(&value) && value->IsNull())) {
+    args->ThrowError("Must pass null or an Array of rules");
+    return;
+  }
+
+  std::vector<WebRequestRules::Rule> rules(dicts.size());
+  for (size_t i = 0; i < dicts.size(); ++i) {
+    std::string error;
+    if (!ParseRule(dicts[i], &rules[i], &error)) {
+      args->ThrowError("Invalid rule at index " + base::SizeTToString(i) +
+                       ": " + error);
+      return;
+    }
+  }
+
+  std::unique_ptr<WebRequestRules> compiled(new WebRequestRules(rules));
+  auto delegate = browser_context_->network_delegate();
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+                          base::Bind(&AtomNetworkDelegate::SetRulesInIO,
+                                     base::Unretained(delegate),
+                                     base::Passed(&compiled)));
 }
 
 // static
@@ -92,6 +252,7 @@ void WebRequest::BuildPrototype(v8::Isolate* isolate,
                                 v8::Local<v8::FunctionTemplate> prototype) {
   prototype->SetClassName(mate::StringToV8(isolate, "WebRequest"));
   mate::ObjectTemplateBuilder(isolate, prototype->PrototypeTemplate())
+      .SetMethod("setRules", &WebRequest::SetRules)
       .SetMethod("onBeforeRequest",
                  &WebRequest::SetResponseListener<
                     AtomNetworkDelegate::kOnBeforeRequest>)
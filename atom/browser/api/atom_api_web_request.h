@@ -36,6 +36,9 @@ class WebRequest : public mate::TrackableObject<WebRequest> {
   template<typename Listener, typename Method, typename Event>
   void SetListener(Method method, Event type, mate::Arguments* args);
 
+  // Replaces the declarative rules evaluated on the IO thread.
+  void SetRules(mate::Arguments* args);
+
  private:
   scoped_refptr<AtomBrowserContext> browser_context_;
 
@@ -94,7 +94,9 @@ Window::Window(v8::Isolate* isolate, v8::Local<v8::Object> wrapper,
 
     // Offscreen windows are always created frameless.
     bool offscreen;
-    if (web_preferences.Get("offscreen", &offscreen) && offscreen) {
+    mate::Dictionary offscreen_options;
+    if ((web_preferences.Get("offscreen", &offscreen) && offscreen) ||
+        web_preferences.Get("offscreen", &offscreen_options)) {
       auto window_options = const_cast<mate::Dictionary&>(options);
       window_options.Set(options::kFrame, false);
     }
@@ -327,6 +329,16 @@ mate::WrappableBase* Window::New(mate::Arguments* args) {
     options = mate::Dictionary::CreateEmpty(args->isolate());
   }
 
+  // Reject invalid options before anything is created with them.
+  mate::Dictionary web_preferences;
+  std::string error;
+  if (options.Get(options::kWebPreferences, &web_preferences) &&
+      !WebContents::CheckOffscreenOptions(web_preferences, &error)) {
+    args->isolate()->ThrowException(v8::Exception::TypeError(
+        mate::StringToV8(args->isolate(), error)));
+    return nullptr;
+  }
+
   return new Window(args->isolate(), args->GetThis(), options);
 }
 
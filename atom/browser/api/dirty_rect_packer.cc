@@ -0,0 +1,166 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/api/dirty_rect_packer.h"
+
+#include <string.h>
+
+#include "third_party/skia/include/core/SkBitmap.h"
+
+namespace atom {
+
+namespace api {
+
+namespace {
+
+const int kBytesPerPixel = 4;
+const int kTileSize = 32;
+
+// Above this number of rectangles they are merged into one, the overhead of
+// handling each rectangle outweighs the saved pixels.
+const size_t kMaxRects = 64;
+
+int64_t Area(const gfx::Rect& rect) {
+  return static_cast<int64_t>(rect.width()) * rect.height();
+}
+
+}  // namespace
+
+DirtyRectPacker::DirtyRectPacker(double merge_threshold)
+    : merge_threshold_(merge_threshold) {
+}
+
+DirtyRectPacker::~DirtyRectPacker() {
+}
+
+void DirtyRectPacker::Update(const gfx::Rect& damage_rect,
+                             const SkBitmap& bitmap,
+                             std::vector<gfx::Rect>* rects) {
+  SkAutoLockPixels bitmap_pixels_lock(bitmap);
+  const uint8_t* pixels = static_cast<const uint8_t*>(bitmap.getPixels());
+  size_t row_bytes = bitmap.rowBytes();
+
+  gfx::Size size(bitmap.width(), bitmap.height());
+  if (size.IsEmpty())
+    return;
+
+  // Everything changes with the size.
+  if (size != size_) {
+    size_ = size;
+    last_frame_.resize(static_cast<size_t>(size_.width()) * size_.height() *
+                       kBytesPerPixel);
+    CopyRect(bitmap, gfx::Rect(size_), last_frame_.data());
+    rects->push_back(gfx::Rect(size_));
+    return;
+  }
+
+  gfx::Rect damage = gfx::IntersectRects(damage_rect, gfx::Rect(size_));
+  if (damage.IsEmpty())
+    return;
+
+  // Collect runs of changed tiles in each row of tiles.
+  std::vector<gfx::Rect> runs;
+  for (int y = damage.y() / kTileSize * kTileSize; y < damage.bottom();
+       y += kTileSize) {
+    gfx::Rect run;
+    for (int x = damage.x() / kTileSize * kTileSize; x < damage.right();
+         x += kTileSize) {
+      gfx::Rect tile = gfx::IntersectRects(
+          gfx::Rect(x, y, kTileSize, kTileSize), damage);
+      if (UpdateTile(tile, pixels, row_bytes)) {
+        run.Union(tile);
+      } else if (!run.IsEmpty()) {
+        runs.push_back(run);
+        run = gfx::Rect();
+      }
+    }
+    if (!run.IsEmpty())
+      runs.push_back(run);
+  }
+
+  MergeRects(&runs);
+  rects->insert(rects->end(), runs.begin(), runs.end());
+}
+
+// static
+void DirtyRectPacker::CopyRect(const SkBitmap& bitmap,
+                               const gfx::Rect& rect,
+                               uint8_t* dest) {
+  SkAutoLockPixels bitmap_pixels_lock(bitmap);
+  const uint8_t* src = static_cast<const uint8_t*>(bitmap.getPixels());
+  size_t length = static_cast<size_t>(rect.width()) * kBytesPerPixel;
+  for (int y = rect.y(); y < rect.bottom(); ++y) {
+    memcpy(dest, src + y * bitmap.rowBytes() + rect.x() * kBytesPerPixel,
+           length);
+    dest += length;
+  }
+}
+
+bool DirtyRectPacker::UpdateTile(const gfx::Rect& tile,
+                                 const uint8_t* pixels,
+                                 size_t row_bytes) {
+  size_t stride = static_cast<size_t>(size_.width()) * kBytesPerPixel;
+  size_t length = static_cast<size_t>(tile.width()) * kBytesPerPixel;
+  bool changed = false;
+  for (int y = tile.y(); y < tile.bottom(); ++y) {
+    const uint8_t* src = pixels + y * row_bytes + tile.x() * kBytesPerPixel;
+    uint8_t* last = last_frame_.data() + y * stride + tile.x() * kBytesPerPixel;
+    if (memcmp(src, last, length) != 0) {
+      memcpy(last, src, length);
+      changed = true;
+    }
+  }
+  return changed;
+}
+
+void DirtyRectPacker::MergeRects(std::vector<gfx::Rect>* rects) const {
+  // Stack runs of the same columns first, which is cheap and covers the
+  // common case of a changed block spanning several rows of tiles.
+  std::vector<gfx::Rect> stacked;
+  for (const gfx::Rect& run : *rects) {
+    bool merged = false;
+    for (gfx::Rect& rect : stacked) {
+      if (rect.x() == run.x() && rect.width() == run.width() &&
+          rect.bottom() == run.y()) {
+        rect.Union(run);
+        merged = true;
+        break;
+      }
+    }
+    if (!merged)
+      stacked.push_back(run);
+  }
+
+  if (stacked.size() > kMaxRects) {
+    gfx::Rect bounds;
+    for (const gfx::Rect& rect : stacked)
+      bounds.Union(rect);
+    rects->assign(1, bounds);
+    return;
+  }
+
+  // Then merge rectangles whose bounds do not add too many unchanged pixels.
+  bool merged = true;
+  while (merged) {
+    merged = false;
+    for (size_t i = 0; i < stacked.size() && !merged; ++i) {
+      for (size_t j = i + 1; j < stacked.size(); ++j) {
+        gfx::Rect bounds = gfx::UnionRects(stacked[i], stacked[j]);
+        int64_t changed = Area(stacked[i]) + Area(stacked[j]) -
+                          Area(gfx::IntersectRects(stacked[i], stacked[j]));
+        if (Area(bounds) - changed <= merge_threshold_ * Area(bounds)) {
+          stacked[i] = bounds;
+          stacked.erase(stacked.begin() + j);
+          merged = true;
+          break;
+        }
+      }
+    }
+  }
+  rects->swap(stacked);
+}
+
+}  // namespace api
+
+}  // namespace atom
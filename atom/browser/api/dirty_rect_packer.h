@@ -0,0 +1,68 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_API_DIRTY_RECT_PACKER_H_
+#define ATOM_BROWSER_API_DIRTY_RECT_PACKER_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "base/macros.h"
+#include "ui/gfx/geometry/rect.h"
+#include "ui/gfx/geometry/size.h"
+
+class SkBitmap;
+
+namespace atom {
+
+namespace api {
+
+// Finds the parts of offscreen frames that actually changed.
+//
+// The damage rect reported by the compositor is often much larger than the
+// changed pixels, e.g. it covers both a caret and a popup far away from it.
+// The packer keeps a copy of the last frame and compares the damaged area
+// tile by tile, then merges the changed tiles into a few rectangles.
+class DirtyRectPacker {
+ public:
+  // |merge_threshold| is the fraction of unchanged pixels a merged rectangle
+  // may contain, higher values give fewer but larger rectangles.
+  explicit DirtyRectPacker(double merge_threshold);
+  ~DirtyRectPacker();
+
+  // Returns the changed rectangles in |damage_rect| of |bitmap|, which may be
+  // empty when nothing changed.
+  void Update(const gfx::Rect& damage_rect,
+              const SkBitmap& bitmap,
+              std::vector<gfx::Rect>* rects);
+
+  // Copies the pixels of |rect| in |bitmap| to |dest| with a stride of
+  // |rect.width()| pixels.
+  static void CopyRect(const SkBitmap& bitmap,
+                       const gfx::Rect& rect,
+                       uint8_t* dest);
+
+ private:
+  // Compares |tile| with the last frame and updates it, returns whether the
+  // tile changed.
+  bool UpdateTile(const gfx::Rect& tile,
+                  const uint8_t* pixels,
+                  size_t row_bytes);
+
+  void MergeRects(std::vector<gfx::Rect>* rects) const;
+
+  const double merge_threshold_;
+
+  gfx::Size size_;
+  std::vector<uint8_t> last_frame_;
+
+  DISALLOW_COPY_AND_ASSIGN(DirtyRectPacker);
+};
+
+}  // namespace api
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_API_DIRTY_RECT_PACKER_H_
@@ -0,0 +1,230 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/api/frame_encoder.h"
+
+#include <utility>
+
+#include "atom/common/native_mate_converters/gfx_converter.h"
+#include "base/bind.h"
+#include "base/task_runner_util.h"
+#include "content/public/browser/browser_thread.h"
+#include "native_mate/dictionary.h"
+#include "third_party/libyuv/include/libyuv/convert.h"
+#include "ui/gfx/codec/jpeg_codec.h"
+#include "ui/gfx/codec/png_codec.h"
+
+#include "atom/common/node_includes.h"
+
+namespace atom {
+
+namespace api {
+
+namespace {
+
+// Frames waiting to be encoded, newer frames are dropped above this.
+const int kMaxPendingFrames = 2;
+
+// libyuv's ARGB is BGRA in memory.
+static_assert(kN32_SkColorType == kBGRA_8888_SkColorType,
+              "N32 bitmaps are expected to be BGRA");
+
+// Converts |bitmap| to I420 with libyuv, which has SIMD row functions for the
+// common architectures.
+bool ConvertToI420(const SkBitmap& bitmap, std::vector<unsigned char>* data) {
+  int width = bitmap.width();
+  int height = bitmap.height();
+  int chroma_width = (width + 1) / 2;
+  int chroma_height = (height + 1) / 2;
+  data->resize(width * height + 2 * chroma_width * chroma_height);
+  unsigned char* y_plane = data->data();
+  unsigned char* u_plane = y_plane + width * height;
+  unsigned char* v_plane = u_plane + chroma_width * chroma_height;
+
+  return libyuv::ARGBToI420(
+      static_cast<const uint8_t*>(bitmap.getPixels()),
+      static_cast<int>(bitmap.rowBytes()), y_plane, width, u_plane,
+      chroma_width, v_plane, chroma_width, width, height) == 0;
+}
+
+std::unique_ptr<FrameEncoder::Frame> EncodeFrame(
+    FrameEncoder::Format format,
+    int quality,
+    const SkBitmap& bitmap,
+    const gfx::Rect& dirty_rect,
+    base::TimeTicks timestamp) {
+  base::TimeTicks start = base::TimeTicks::Now();
+  std::unique_ptr<FrameEncoder::Frame> frame(new FrameEncoder::Frame);
+  frame->format = format;
+  frame->size = gfx::Size(bitmap.width(), bitmap.height());
+  frame->dirty_rect = dirty_rect;
+  frame->timestamp = timestamp;
+
+  SkAutoLockPixels bitmap_pixels_lock(bitmap);
+  bool success = false;
+  switch (format) {
+    case FrameEncoder::Format::JPEG:
+      success = gfx::JPEGCodec::Encode(
+          static_cast<const unsigned char*>(bitmap.getPixels()),
+          gfx::JPEGCodec::FORMAT_SkBitmap, bitmap.width(), bitmap.height(),
+          static_cast<int>(bitmap.rowBytes()), quality, &frame->data);
+      break;
+    case FrameEncoder::Format::PNG:
+      success = gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false, &frame->data);
+      break;
+    case FrameEncoder::Format::I420:
+      success = ConvertToI420(bitmap, &frame->data);
+      break;
+  }
+  if (!success)
+    return nullptr;
+
+  frame->encode_time = base::TimeTicks::Now() - start;
+  return frame;
+}
+
+void FreeEncodedData(char* data, void* hint) {
+  delete static_cast<std::vector<unsigned char>*>(hint);
+}
+
+const char* FormatToString(FrameEncoder::Format format) {
+  switch (format) {
+    case FrameEncoder::Format::JPEG: return "jpeg";
+    case FrameEncoder::Format::PNG: return "png";
+    case FrameEncoder::Format::I420: return "i420";
+  }
+  return "";
+}
+
+}  // namespace
+
+FrameEncoder::Frame::Frame() : format(Format::JPEG) {}
+
+FrameEncoder::Frame::~Frame() {}
+
+// static
+std::unique_ptr<FrameEncoder> FrameEncoder::Create(
+    const mate::Dictionary& options, std::string* error) {
+  Format format;
+  int quality;
+  if (!ParseOptions(options, &format, &quality, error))
+    return nullptr;
+  return std::unique_ptr<FrameEncoder>(new FrameEncoder(format, quality));
+}
+
+// static
+bool FrameEncoder::CheckOptions(const mate::Dictionary& options,
+                                std::string* error) {
+  Format format;
+  int quality;
+  return ParseOptions(options, &format, &quality, error);
+}
+
+// static
+bool FrameEncoder::ParseOptions(const mate::Dictionary& options,
+                                Format* format,
+                                int* quality,
+                                std::string* error) {
+  std::string name;
+  options.Get("format", &name);
+  if (name == "jpeg") {
+    *format = Format::JPEG;
+  } else if (name == "png") {
+    *format = Format::PNG;
+  } else if (name == "i420") {
+    *format = Format::I420;
+  } else {
+    *error = "Invalid encoder format, must be jpeg, png or i420";
+    return false;
+  }
+
+  *quality = 90;
+  options.Get("quality", quality);
+  if (*quality < 0 || *quality > 100) {
+    *error = "Invalid encoder quality, must be between 0 and 100";
+    return false;
+  }
+  return true;
+}
+
+FrameEncoder::FrameEncoder(Format format, int quality)
+    : format_(format),
+      quality_(quality),
+      pending_frames_(0),
+      weak_factory_(this) {
+  // Frames are encoded in order on their own sequence.
+  base::SequencedWorkerPool* pool = content::BrowserThread::GetBlockingPool();
+  task_runner_ = pool->GetSequencedTaskRunnerWithShutdownBehavior(
+      pool->GetSequenceToken(), base::SequencedWorkerPool::SKIP_ON_SHUTDOWN);
+}
+
+FrameEncoder::~FrameEncoder() {
+}
+
+bool FrameEncoder::Encode(const SkBitmap& bitmap,
+                          const gfx::Rect& dirty_rect,
+                          base::TimeTicks timestamp,
+                          const EncodedCallback& callback) {
+  if (pending_frames_ >= kMaxPendingFrames) {
+    dropped_rect_.Union(dirty_rect);
+    return false;
+  }
+
+  SkBitmap frame = bitmap;
+  if (!bitmap.isImmutable() && !bitmap.deepCopyTo(&frame)) {
+    dropped_rect_.Union(dirty_rect);
+    return false;
+  }
+
+  gfx::Rect rect = gfx::UnionRects(dirty_rect, dropped_rect_);
+  dropped_rect_ = gfx::Rect();
+
+  ++pending_frames_;
+  base::PostTaskAndReplyWithResult(
+      task_runner_.get(), FROM_HERE,
+      base::Bind(&EncodeFrame, format_, quality_, frame, rect, timestamp),
+      base::Bind(&FrameEncoder::OnEncoded, weak_factory_.GetWeakPtr(),
+                 callback, rect));
+  return true;
+}
+
+// static
+mate::Dictionary FrameEncoder::FrameToDictionary(
+    v8::Isolate* isolate, std::unique_ptr<Frame> frame) {
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
+  // Hand the encoded data to the Buffer without copying it again.
+  std::vector<unsigned char>* data =
+      new std::vector<unsigned char>(std::move(frame->data));
+  v8::Local<v8::Object> buffer;
+  if (node::Buffer::New(isolate, reinterpret_cast<char*>(data->data()),
+                        data->size(), &FreeEncodedData, data)
+          .ToLocal(&buffer)) {
+    dict.Set("data", buffer);
+  } else {
+    delete data;
+  }
+  dict.Set("format", FormatToString(frame->format));
+  dict.Set("size", frame->size);
+  dict.Set("dirtyRect", frame->dirty_rect);
+  dict.Set("timestamp",
+           (frame->timestamp - base::TimeTicks()).InMillisecondsF());
+  dict.Set("encodeTime", frame->encode_time.InMillisecondsF());
+  return dict;
+}
+
+void FrameEncoder::OnEncoded(const EncodedCallback& callback,
+                             const gfx::Rect& dirty_rect,
+                             std::unique_ptr<Frame> frame) {
+  --pending_frames_;
+  if (frame) {
+    callback.Run(std::move(frame));
+  } else {
+    // The next frame has to cover what this one failed to deliver.
+    dropped_rect_.Union(dirty_rect);
+  }
+}
+
+}  // namespace api
+
+}  // namespace atom
@@ -0,0 +1,107 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_API_FRAME_ENCODER_H_
+#define ATOM_BROWSER_API_FRAME_ENCODER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequenced_task_runner.h"
+#include "base/time/time.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/geometry/rect.h"
+#include "v8/include/v8.h"
+
+namespace mate {
+class Dictionary;
+}
+
+namespace atom {
+
+namespace api {
+
+// Compresses captured frames on a worker thread, used by offscreen rendering
+// and frame subscriptions so the UI thread never handles raw pixels in JS.
+class FrameEncoder {
+ public:
+  enum class Format {
+    JPEG,
+    PNG,
+    // Planar YUV 4:2:0, the Y plane followed by the U and V planes.
+    I420,
+  };
+
+  struct Frame {
+    Frame();
+    ~Frame();
+
+    Format format;
+    std::vector<unsigned char> data;
+    gfx::Size size;
+    gfx::Rect dirty_rect;
+    // When the frame was captured, and how long the encoding took.
+    base::TimeTicks timestamp;
+    base::TimeDelta encode_time;
+  };
+
+  using EncodedCallback = base::Callback<void(std::unique_ptr<Frame>)>;
+
+  // Creates the encoder from the {format, quality} |options|, returns nullptr
+  // and sets |error| when they are invalid.
+  static std::unique_ptr<FrameEncoder> Create(const mate::Dictionary& options,
+                                              std::string* error);
+
+  // Whether Create would accept |options|, sets |error| when it would not.
+  static bool CheckOptions(const mate::Dictionary& options,
+                           std::string* error);
+
+  FrameEncoder(Format format, int quality);
+  ~FrameEncoder();
+
+  // Encodes |bitmap| on the worker thread, |callback| is called on the
+  // calling thread with the result. The pixels are copied unless |bitmap| is
+  // immutable. Returns false and drops the frame when too many frames are
+  // waiting to be encoded, its dirty rect is merged into the next frame.
+  bool Encode(const SkBitmap& bitmap,
+              const gfx::Rect& dirty_rect,
+              base::TimeTicks timestamp,
+              const EncodedCallback& callback);
+
+  // Converts |frame| to {data, format, size, dirtyRect, timestamp,
+  // encodeTime}.
+  static mate::Dictionary FrameToDictionary(v8::Isolate* isolate,
+                                            std::unique_ptr<Frame> frame);
+
+ private:
+  static bool ParseOptions(const mate::Dictionary& options,
+                           Format* format,
+                           int* quality,
+                           std::string* error);
+
+  void OnEncoded(const EncodedCallback& callback,
+                 const gfx::Rect& dirty_rect,
+                 std::unique_ptr<Frame> frame);
+
+  const Format format_;
+  const int quality_;
+
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+  int pending_frames_;
+  // Dirty rects of the frames that were dropped or failed to encode.
+  gfx::Rect dropped_rect_;
+
+  base::WeakPtrFactory<FrameEncoder> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(FrameEncoder);
+};
+
+}  // namespace api
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_API_FRAME_ENCODER_H_
@@ -4,9 +4,14 @@
 
 #include "atom/browser/api/frame_subscriber.h"
 
+#include <utility>
+#include <vector>
+
 #include "atom/common/native_mate_converters/gfx_converter.h"
 #include "base/bind.h"
 #include "content/public/browser/render_widget_host.h"
+#include "media/base/video_frame.h"
+#include "native_mate/dictionary.h"
 #include "ui/display/display.h"
 #include "ui/display/screen.h"
 
@@ -16,18 +21,53 @@ namespace atom {
 
 namespace api {
 
+namespace {
+
+void ReleaseVideoFrame(char* data, void* hint) {
+  static_cast<media::VideoFrame*>(hint)->Release();
+}
+
+// Wraps |plane| of |frame| in a Buffer that keeps |frame| out of the pool
+// until it is garbage collected.
+v8::Local<v8::Value> PlaneToBuffer(
+    v8::Isolate* isolate,
+    const scoped_refptr<media::VideoFrame>& frame,
+    size_t plane) {
+  size_t length = static_cast<size_t>(frame->stride(plane)) *
+                  frame->rows(plane);
+  char* data = reinterpret_cast<char*>(
+      const_cast<uint8_t*>(frame->data(plane)));
+  frame->AddRef();
+  v8::Local<v8::Object> buffer;
+  if (!node::Buffer::New(isolate, data, length, &ReleaseVideoFrame,
+                         frame.get()).ToLocal(&buffer)) {
+    frame->Release();
+    return v8::Null(isolate);
+  }
+  return buffer;
+}
+
+}  // namespace
+
 FrameSubscriber::FrameSubscriber(v8::Isolate* isolate,
                                  content::RenderWidgetHostView* view,
                                  const FrameCaptureCallback& callback,
-                                 bool only_dirty)
+                                 bool only_dirty,
+                                 Format format,
+                                 std::unique_ptr<FrameEncoder> encoder)
     : isolate_(isolate),
       view_(view),
       callback_(callback),
       only_dirty_(only_dirty),
+      format_(format),
+      encoder_(std::move(encoder)),
       source_id_for_copy_request_(base::UnguessableToken::Create()),
       weak_factory_(this) {
 }
 
+FrameSubscriber::~FrameSubscriber() {
+}
+
 bool FrameSubscriber::ShouldCaptureFrame(
     const gfx::Rect& dirty_rect,
     base::TimeTicks present_time,
@@ -40,7 +80,8 @@ bool FrameSubscriber::ShouldCaptureFrame(
     return false;
 
   gfx::Rect rect = gfx::Rect(view_->GetVisibleViewportSize());
-  if (only_dirty_)
+  // The compositor always converts the whole surface into video frames.
+  if (only_dirty_ && format_ == Format::BGRA)
     rect = dirty_rect;
 
   gfx::Size view_size = rect.size();
@@ -52,13 +93,30 @@ bool FrameSubscriber::ShouldCaptureFrame(
   if (scale > 1.0f)
     bitmap_size = gfx::ScaleToCeiledSize(view_size, scale);
 
+  if (format_ == Format::I420) {
+    // Chroma planes are subsampled by two, keep the frame size even.
+    gfx::Size frame_size((bitmap_size.width() + 1) & ~1,
+                         (bitmap_size.height() + 1) & ~1);
+    scoped_refptr<media::VideoFrame> frame = frame_pool_.CreateFrame(
+        media::PIXEL_FORMAT_I420, frame_size, gfx::Rect(frame_size),
+        frame_size, base::TimeDelta());
+    if (!frame)
+      return false;
+
+    // Returning the frame makes the compositor read back straight into it.
+    *storage = frame;
+    *callback = base::Bind(&FrameSubscriber::OnVideoFrameDelivered,
+                           weak_factory_.GetWeakPtr(), frame, dirty_rect);
+    return true;
+  }
+
   rect = gfx::Rect(rect.origin(), bitmap_size);
 
   view_->CopyFromSurface(
       rect,
       rect.size(),
       base::Bind(&FrameSubscriber::OnFrameDelivered,
-                 weak_factory_.GetWeakPtr(), callback_, rect),
+                 weak_factory_.GetWeakPtr(), callback_, rect, present_time),
       kBGRA_8888_SkColorType);
 
   return false;
@@ -70,11 +128,23 @@ const base::UnguessableToken& FrameSubscriber::GetSourceIdForCopyRequest() {
 
 void FrameSubscriber::OnFrameDelivered(const FrameCaptureCallback& callback,
                                        const gfx::Rect& damage_rect,
+                                       base::TimeTicks present_time,
                                        const SkBitmap& bitmap,
                                        content::ReadbackResponse response) {
   if (response != content::ReadbackResponse::READBACK_SUCCESS)
     return;
 
+  if (encoder_) {
+    // The readback result is not used by anyone else, so the encoder can
+    // share its pixels.
+    SkBitmap frame = bitmap;
+    frame.setImmutable();
+    encoder_->Encode(frame, damage_rect, present_time,
+                     base::Bind(&FrameSubscriber::OnFrameEncoded,
+                                weak_factory_.GetWeakPtr()));
+    return;
+  }
+
   v8::Locker locker(isolate_);
   v8::HandleScope handle_scope(isolate_);
 
@@ -91,7 +161,58 @@ void FrameSubscriber::OnFrameDelivered(const FrameCaptureCallback& callback,
   v8::Local<v8::Value> damage =
       mate::Converter<gfx::Rect>::ToV8(isolate_, damage_rect);
 
-  callback_.Run(buffer.ToLocalChecked(), damage);
+  callback_.Run(buffer.ToLocalChecked(), damage, v8::Undefined(isolate_));
+}
+
+void FrameSubscriber::OnFrameEncoded(
+    std::unique_ptr<FrameEncoder::Frame> frame) {
+  v8::Locker locker(isolate_);
+  v8::HandleScope handle_scope(isolate_);
+
+  v8::Local<v8::Value> damage =
+      mate::Converter<gfx::Rect>::ToV8(isolate_, frame->dirty_rect);
+  mate::Dictionary info =
+      FrameEncoder::FrameToDictionary(isolate_, std::move(frame));
+  v8::Local<v8::Value> data;
+  if (!info.Get("data", &data))
+    return;
+
+  callback_.Run(data, damage, info.GetHandle());
+}
+
+void FrameSubscriber::OnVideoFrameDelivered(
+    scoped_refptr<media::VideoFrame> frame,
+    const gfx::Rect& damage_rect,
+    base::TimeTicks timestamp,
+    const gfx::Rect& region_in_frame,
+    bool success) {
+  if (!success)
+    return;
+
+  v8::Locker locker(isolate_);
+  v8::HandleScope handle_scope(isolate_);
+
+  std::vector<mate::Dictionary> planes;
+  for (size_t plane = media::VideoFrame::kYPlane;
+       plane <= media::VideoFrame::kVPlane; ++plane) {
+    mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate_);
+    dict.Set("data", PlaneToBuffer(isolate_, frame, plane));
+    dict.Set("stride", frame->stride(plane));
+    planes.push_back(dict);
+  }
+
+  mate::Dictionary info = mate::Dictionary::CreateEmpty(isolate_);
+  info.Set("format", "i420");
+  info.Set("size", frame->visible_rect().size());
+  info.Set("contentRect", region_in_frame);
+  info.Set("timestamp", (timestamp - base::TimeTicks()).InMillisecondsF());
+  info.Set("planes", planes);
+
+  v8::Local<v8::Value> luma;
+  planes[0].Get("data", &luma);
+  v8::Local<v8::Value> damage =
+      mate::Converter<gfx::Rect>::ToV8(isolate_, damage_rect);
+  callback_.Run(luma, damage, info.GetHandle());
 }
 
 }  // namespace api
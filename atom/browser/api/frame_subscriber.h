@@ -5,11 +5,15 @@
 #ifndef ATOM_BROWSER_API_FRAME_SUBSCRIBER_H_
 #define ATOM_BROWSER_API_FRAME_SUBSCRIBER_H_
 
+#include <memory>
+
+#include "atom/browser/api/frame_encoder.h"
 #include "base/callback.h"
 #include "base/memory/weak_ptr.h"
 #include "content/browser/renderer_host/render_widget_host_view_frame_subscriber.h"
 #include "content/public/browser/readback_types.h"
 #include "content/public/browser/render_widget_host_view.h"
+#include "media/base/video_frame_pool.h"
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "ui/gfx/geometry/size.h"
 #include "v8/include/v8.h"
@@ -20,13 +24,25 @@ namespace api {
 
 class FrameSubscriber : public content::RenderWidgetHostViewFrameSubscriber {
  public:
-  using FrameCaptureCallback =
-      base::Callback<void(v8::Local<v8::Value>, v8::Local<v8::Value>)>;
+  using FrameCaptureCallback = base::Callback<void(v8::Local<v8::Value>,
+                                                   v8::Local<v8::Value>,
+                                                   v8::Local<v8::Value>)>;
+
+  // Pixel format of the frames read back from the compositor.
+  enum class Format {
+    BGRA,
+    // Converted on the GPU into pooled video frames.
+    I420,
+  };
 
+  // When |encoder| is not null, frames are encoded before being delivered.
   FrameSubscriber(v8::Isolate* isolate,
                   content::RenderWidgetHostView* view,
                   const FrameCaptureCallback& callback,
-                  bool only_dirty);
+                  bool only_dirty,
+                  Format format,
+                  std::unique_ptr<FrameEncoder> encoder);
+  ~FrameSubscriber() override;
 
   bool ShouldCaptureFrame(const gfx::Rect& damage_rect,
                           base::TimeTicks present_time,
@@ -37,13 +53,25 @@ class FrameSubscriber : public content::RenderWidgetHostViewFrameSubscriber {
  private:
   void OnFrameDelivered(const FrameCaptureCallback& callback,
                         const gfx::Rect& damage_rect,
+                        base::TimeTicks present_time,
                         const SkBitmap& bitmap,
                         content::ReadbackResponse response);
+  void OnFrameEncoded(std::unique_ptr<FrameEncoder::Frame> frame);
+  void OnVideoFrameDelivered(scoped_refptr<media::VideoFrame> frame,
+                             const gfx::Rect& damage_rect,
+                             base::TimeTicks timestamp,
+                             const gfx::Rect& region_in_frame,
+                             bool success);
 
   v8::Isolate* isolate_;
   content::RenderWidgetHostView* view_;
   FrameCaptureCallback callback_;
   bool only_dirty_;
+  Format format_;
+  std::unique_ptr<FrameEncoder> encoder_;
+
+  // Frames go back to the pool once JS releases all their planes.
+  media::VideoFramePool frame_pool_;
 
   base::UnguessableToken source_id_for_copy_request_;
 
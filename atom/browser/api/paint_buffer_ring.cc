@@ -0,0 +1,111 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/api/paint_buffer_ring.h"
+
+#include <string.h>
+
+#include "third_party/skia/include/core/SkBitmap.h"
+
+namespace atom {
+
+namespace api {
+
+PaintBufferRing::Buffer::Buffer() : held(false) {}
+
+PaintBufferRing::Buffer::~Buffer() {}
+
+PaintBufferRing::PaintBufferRing(v8::Isolate* isolate, size_t size)
+    : isolate_(isolate) {
+  for (size_t i = 0; i < size; ++i)
+    buffers_.push_back(std::unique_ptr<Buffer>(new Buffer));
+}
+
+PaintBufferRing::~PaintBufferRing() {
+  v8::HandleScope handle_scope(isolate_);
+  FreeBuffers();
+}
+
+bool PaintBufferRing::Write(const gfx::Rect& damage_rect,
+                            const SkBitmap& bitmap,
+                            int* index,
+                            gfx::Rect* dirty_rect) {
+  gfx::Size size(bitmap.width(), bitmap.height());
+  if (size.IsEmpty())
+    return false;
+  if (size != size_)
+    Reset(size);
+
+  gfx::Rect bounds(size_);
+  gfx::Rect damage = gfx::IntersectRects(damage_rect, bounds);
+  pending_damage_.Union(damage);
+
+  Buffer* buffer = nullptr;
+  for (size_t i = 0; i < buffers_.size(); ++i) {
+    buffers_[i]->stale_rect.Union(damage);
+    if (!buffer && !buffers_[i]->held) {
+      buffer = buffers_[i].get();
+      *index = static_cast<int>(i);
+    }
+  }
+  if (!buffer)
+    return false;
+
+  // Only copy what changed since this buffer was last written.
+  SkAutoLockPixels bitmap_pixels_lock(bitmap);
+  const gfx::Rect& rect = buffer->stale_rect;
+  const uint8_t* src = static_cast<const uint8_t*>(bitmap.getPixels());
+  for (int y = rect.y(); y < rect.bottom(); ++y) {
+    memcpy(buffer->pixels.get() + y * stride() + rect.x() * kBytesPerPixel,
+           src + y * bitmap.rowBytes() + rect.x() * kBytesPerPixel,
+           rect.width() * kBytesPerPixel);
+  }
+
+  buffer->stale_rect = gfx::Rect();
+  buffer->held = true;
+  *dirty_rect = pending_damage_;
+  pending_damage_ = gfx::Rect();
+  return true;
+}
+
+void PaintBufferRing::Release(int index) {
+  if (index >= 0 && index < static_cast<int>(buffers_.size()))
+    buffers_[index]->held = false;
+}
+
+v8::Local<v8::ArrayBuffer> PaintBufferRing::GetArrayBuffer(int index) const {
+  return v8::Local<v8::ArrayBuffer>::New(isolate_,
+                                         buffers_[index]->array_buffer);
+}
+
+void PaintBufferRing::Reset(const gfx::Size& size) {
+  FreeBuffers();
+
+  size_ = size;
+  size_t length = static_cast<size_t>(stride()) * size_.height();
+  for (auto& buffer : buffers_) {
+    buffer->pixels.reset(new uint8_t[length]);
+    buffer->array_buffer.Reset(
+        isolate_, v8::ArrayBuffer::New(isolate_, buffer->pixels.get(), length));
+    buffer->stale_rect = gfx::Rect(size_);
+    buffer->held = false;
+  }
+  pending_damage_ = gfx::Rect(size_);
+}
+
+void PaintBufferRing::FreeBuffers() {
+  for (auto& buffer : buffers_) {
+    if (!buffer->array_buffer.IsEmpty()) {
+      v8::Local<v8::ArrayBuffer> array_buffer =
+          v8::Local<v8::ArrayBuffer>::New(isolate_, buffer->array_buffer);
+      array_buffer->Neuter();
+      buffer->array_buffer.Reset();
+    }
+    buffer->pixels.reset();
+  }
+}
+
+}  // namespace api
+
+}  // namespace atom
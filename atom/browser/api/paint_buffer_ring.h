@@ -0,0 +1,87 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_API_PAINT_BUFFER_RING_H_
+#define ATOM_BROWSER_API_PAINT_BUFFER_RING_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "base/macros.h"
+#include "ui/gfx/geometry/rect.h"
+#include "ui/gfx/geometry/size.h"
+#include "v8/include/v8.h"
+
+class SkBitmap;
+
+namespace atom {
+
+namespace api {
+
+// A fixed number of persistent pixel buffers that offscreen frames are
+// delivered in, each exposed to JavaScript as an ArrayBuffer backed by the
+// buffer itself.
+//
+// A buffer is held by JavaScript from the time a frame is written to it until
+// it is released. Every buffer remembers the area painted since it was last
+// written, so only the changed pixels are copied when it is reused.
+class PaintBufferRing {
+ public:
+  PaintBufferRing(v8::Isolate* isolate, size_t size);
+  ~PaintBufferRing();
+
+  // Copies the frame in |bitmap| into a free buffer. Returns false when all
+  // buffers are held, in which case |damage_rect| is merged into the dirty
+  // rect of the next delivered frame.
+  bool Write(const gfx::Rect& damage_rect,
+             const SkBitmap& bitmap,
+             int* index,
+             gfx::Rect* dirty_rect);
+
+  // Gives buffer |index| back to the ring.
+  void Release(int index);
+
+  // Returns the ArrayBuffer of buffer |index|, the caller must hold a
+  // HandleScope.
+  v8::Local<v8::ArrayBuffer> GetArrayBuffer(int index) const;
+
+  const gfx::Size& size() const { return size_; }
+  int stride() const { return size_.width() * kBytesPerPixel; }
+
+ private:
+  static const int kBytesPerPixel = 4;
+
+  struct Buffer {
+    Buffer();
+    ~Buffer();
+
+    std::unique_ptr<uint8_t[]> pixels;
+    v8::Global<v8::ArrayBuffer> array_buffer;
+    // The area painted since the buffer was last written.
+    gfx::Rect stale_rect;
+    bool held;
+  };
+
+  // Reallocates all buffers for frames of |size|. ArrayBuffers of the old
+  // buffers are neutered so JavaScript can never access freed memory.
+  void Reset(const gfx::Size& size);
+  void FreeBuffers();
+
+  v8::Isolate* isolate_;
+  std::vector<std::unique_ptr<Buffer>> buffers_;
+  gfx::Size size_;
+
+  // The area painted since the last delivered frame.
+  gfx::Rect pending_damage_;
+
+  DISALLOW_COPY_AND_ASSIGN(PaintBufferRing);
+};
+
+}  // namespace api
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_API_PAINT_BUFFER_RING_H_
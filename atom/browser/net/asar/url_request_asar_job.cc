@@ -4,6 +4,8 @@
 
 #include "atom/browser/net/asar/url_request_asar_job.h"
 
+#include <inttypes.h>
+
 #include <string>
 #include <vector>
 
@@ -12,9 +14,12 @@
 #include "atom/common/atom_constants.h"
 #include "base/bind.h"
 #include "base/files/file_util.h"
+#include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
 #include "base/synchronization/lock.h"
 #include "base/task_runner.h"
+#include "base/time/time.h"
 #include "net/base/file_stream.h"
 #include "net/base/filename_util.h"
 #include "net/base/io_buffer.h"
@@ -22,6 +27,8 @@
 #include "net/base/mime_util.h"
 #include "net/base/net_errors.h"
 #include "net/filter/gzip_source_stream.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_status_code.h"
 #include "net/http/http_util.h"
 #include "net/url_request/url_request_status.h"
 
@@ -31,6 +38,28 @@
 
 namespace asar {
 
+namespace {
+
+// Formats |time| as an HTTP-date (RFC 7231), e.g.
+// "Sun, 06 Nov 1994 08:49:37 GMT".
+std::string FormatHTTPDate(const base::Time& time) {
+  static const char* const kWeekdays[] = {
+    "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"
+  };
+  static const char* const kMonths[] = {
+    "Jan", "Feb", "Mar", "Apr", "May", "Jun",
+    "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+  };
+  base::Time::Exploded exploded;
+  time.UTCExplode(&exploded);
+  return base::StringPrintf(
+      "%s, %02d %s %04d %02d:%02d:%02d GMT", kWeekdays[exploded.day_of_week],
+      exploded.day_of_month, kMonths[exploded.month - 1], exploded.year,
+      exploded.hour, exploded.minute, exploded.second);
+}
+
+}  // namespace
+
 URLRequestAsarJob::FileMetaInfo::FileMetaInfo()
     : file_size(0),
       mime_type_result(false),
@@ -46,6 +75,9 @@ URLRequestAsarJob::URLRequestAsarJob(
       remaining_bytes_(0),
       seek_offset_(0),
       range_parse_result_(net::OK),
+      range_requested_(false),
+      total_size_(0),
+      response_code_(net::HTTP_OK),
       weak_ptr_factory_(this) {}
 
 URLRequestAsarJob::~URLRequestAsarJob() {}
@@ -182,6 +214,10 @@ bool URLRequestAsarJob::IsRedirectResponse(GURL* location,
 std::unique_ptr<net::SourceStream> URLRequestAsarJob::SetUpSourceStream() {
   std::unique_ptr<net::SourceStream> source =
       net::URLRequestJob::SetUpSourceStream();
+  // Compressed entries are inflated incrementally while being read.
+  if (type_ == TYPE_ASAR && file_info_.compressed)
+    source = net::GzipSourceStream::Create(std::move(source),
+                                           net::SourceStream::TYPE_DEFLATE);
   // Bug 9936 - .svgz files needs to be decompressed.
   return base::LowerCaseEqualsASCII(file_path_.Extension(), ".svgz")
       ? net::GzipSourceStream::Create(std::move(source),
@@ -213,23 +249,51 @@ void URLRequestAsarJob::SetExtraRequestHeaders(
     if (net::HttpUtil::ParseRangeHeader(range_header, &ranges)) {
       if (ranges.size() == 1) {
         byte_range_ = ranges[0];
+        range_requested_ = true;
       } else {
         range_parse_result_ = net::ERR_REQUEST_RANGE_NOT_SATISFIABLE;
       }
     }
   }
+
+  headers.GetHeader(net::HttpRequestHeaders::kIfNoneMatch, &if_none_match_);
+  headers.GetHeader(net::HttpRequestHeaders::kIfModifiedSince,
+                    &if_modified_since_);
+  headers.GetHeader(net::HttpRequestHeaders::kIfRange, &if_range_);
 }
 
 int URLRequestAsarJob::GetResponseCode() const {
   // Request Job gets created only if path exists.
-  return 200;
+  return response_code_;
 }
 
 void URLRequestAsarJob::GetResponseInfo(net::HttpResponseInfo* info) {
-  std::string status("HTTP/1.1 200 OK");
+  std::string status = base::StringPrintf(
+      "HTTP/1.1 %d %s", response_code_,
+      net::GetHttpReasonPhrase(
+          static_cast<net::HttpStatusCode>(response_code_)));
+  status.append("\0\0", 2);
   auto* headers = new net::HttpResponseHeaders(status);
 
   headers->AddHeader(atom::kCORSHeader);
+
+  if (type_ == TYPE_ASAR) {
+    headers->AddHeader("ETag: " + GetETag());
+    headers->AddHeader("Last-Modified: " +
+                       FormatHTTPDate(archive_->last_modified()));
+    if (!file_info_.compressed)
+      headers->AddHeader("Accept-Ranges: bytes");
+    if (response_code_ == net::HTTP_PARTIAL_CONTENT) {
+      headers->AddHeader(base::StringPrintf(
+          "Content-Range: bytes %" PRId64 "-%" PRId64 "/%" PRId64,
+          byte_range_.first_byte_position(), byte_range_.last_byte_position(),
+          total_size_));
+    } else if (response_code_ == net::HTTP_REQUESTED_RANGE_NOT_SATISFIABLE) {
+      headers->AddHeader(base::StringPrintf(
+          "Content-Range: bytes */%" PRId64, total_size_));
+    }
+  }
+
   info->headers = headers;
 }
 
@@ -279,7 +343,23 @@ void URLRequestAsarJob::DidOpen(int result) {
 
   int64_t file_size, read_offset;
   if (type_ == TYPE_ASAR) {
-    file_size = file_info_.size;
+    if (IsNotModified()) {
+      response_code_ = net::HTTP_NOT_MODIFIED;
+      remaining_bytes_ = 0;
+      set_expected_content_size(0);
+      NotifyHeadersComplete();
+      return;
+    }
+
+    // The compressed stream can not be seeked, so always send all of it, and
+    // a range for an older version of the file is also ignored.
+    if (file_info_.compressed ||
+        (!if_range_.empty() && if_range_ != GetETag())) {
+      byte_range_ = net::HttpByteRange();
+      range_requested_ = false;
+    }
+    file_size = file_info_.compressed ? file_info_.compressed_size
+                                      : file_info_.size;
     read_offset = file_info_.offset;
   } else {
     file_size = meta_info_.file_size;
@@ -287,6 +367,15 @@ void URLRequestAsarJob::DidOpen(int result) {
   }
 
   if (!byte_range_.ComputeBounds(file_size)) {
+    // A range past the end of a packed file gets a 416 telling its real size.
+    if (type_ == TYPE_ASAR && range_requested_) {
+      response_code_ = net::HTTP_REQUESTED_RANGE_NOT_SATISFIABLE;
+      total_size_ = file_size;
+      remaining_bytes_ = 0;
+      set_expected_content_size(0);
+      NotifyHeadersComplete();
+      return;
+    }
     NotifyStartError(
         net::URLRequestStatus(net::URLRequestStatus::FAILED,
                               net::ERR_REQUEST_RANGE_NOT_SATISFIABLE));
@@ -297,6 +386,11 @@ void URLRequestAsarJob::DidOpen(int result) {
                      byte_range_.first_byte_position() + 1;
   seek_offset_ = byte_range_.first_byte_position() + read_offset;
 
+  if (type_ == TYPE_ASAR && range_requested_) {
+    response_code_ = net::HTTP_PARTIAL_CONTENT;
+    total_size_ = file_size;
+  }
+
   if (remaining_bytes_ > 0 && seek_offset_ != 0) {
     int rv = stream_->Seek(seek_offset_,
                            base::Bind(&URLRequestAsarJob::DidSeek,
@@ -325,6 +419,36 @@ void URLRequestAsarJob::DidSeek(int64_t result) {
   NotifyHeadersComplete();
 }
 
+std::string URLRequestAsarJob::GetETag() const {
+  return base::StringPrintf(
+      "\"%" PRIx64 "-%" PRIx64 "-%x\"",
+      static_cast<uint64_t>(archive_->last_modified().ToInternalValue()),
+      file_info_.offset,
+      file_info_.size);
+}
+
+bool URLRequestAsarJob::IsNotModified() const {
+  // If-None-Match takes precedence over If-Modified-Since.
+  if (!if_none_match_.empty()) {
+    std::string etag = GetETag();
+    for (const base::StringPiece& tag : base::SplitStringPiece(
+             if_none_match_, ",", base::TRIM_WHITESPACE,
+             base::SPLIT_WANT_NONEMPTY)) {
+      // Weak comparison is used for If-None-Match.
+      if (tag == "*" || tag == etag ||
+          (tag.starts_with("W/") && tag.substr(2) == etag))
+        return true;
+    }
+    return false;
+  }
+
+  base::Time since;
+  return !if_modified_since_.empty() &&
+         base::Time::FromString(if_modified_since_.c_str(), &since) &&
+         // HTTP dates only have a precision of seconds.
+         archive_->last_modified().ToTimeT() <= since.ToTimeT();
+}
+
 void URLRequestAsarJob::DidRead(scoped_refptr<net::IOBuffer> buf, int result) {
   if (result >= 0) {
     remaining_bytes_ -= result;
@@ -100,6 +100,13 @@ class URLRequestAsarJob : public net::URLRequestJob {
   // Callback after data is asynchronously read from the file into |buf|.
   void DidRead(scoped_refptr<net::IOBuffer> buf, int result);
 
+  // Returns the validator of the packed file, derived from the archive's
+  // modification time and the file's position inside it.
+  std::string GetETag() const;
+
+  // Whether the conditional request headers match the packed file.
+  bool IsNotModified() const;
+
   // The type of this job.
   enum JobType {
     TYPE_ERROR,
@@ -121,6 +128,17 @@ class URLRequestAsarJob : public net::URLRequestJob {
   int64_t seek_offset_;
 
   net::Error range_parse_result_;
+  bool range_requested_;
+
+  // Headers of conditional requests.
+  std::string if_none_match_;
+  std::string if_modified_since_;
+  std::string if_range_;
+
+  // The size of the whole packed file when responding with a partial content
+  // or an unsatisfiable range.
+  int64_t total_size_;
+  int response_code_;
 
   base::WeakPtrFactory<URLRequestAsarJob> weak_ptr_factory_;
 
@@ -6,9 +6,11 @@
 
 #include <utility>
 
+#include "atom/browser/net/web_request_rules.h"
 #include "atom/common/native_mate_converters/net_converter.h"
 #include "base/stl_util.h"
 #include "base/strings/string_util.h"
+#include "base/supports_user_data.h"
 #include "brightray/browser/net/devtools_network_transaction.h"
 #include "content/public/browser/browser_thread.h"
 #include "net/url_request/url_request.h"
@@ -44,34 +46,69 @@ namespace {
 using ResponseHeadersContainer =
     std::pair<scoped_refptr<net::HttpResponseHeaders>*, const std::string&>;
 
+const char* kUploadDataKey = "UploadDataKey";
+
+// The keys of the response object read by ReadFromResponseObject.
+const char* kResponseKeys[] = {
+  "cancel", "redirectURL", "requestHeaders", "responseHeaders", "statusLine",
+};
+
+// Keeps the upload data of a request, so all of its events share it.
+class UploadDataUserData : public base::SupportsUserData::Data {
+ public:
+  UploadDataUserData(const net::UploadDataStream* stream,
+                     scoped_refptr<UploadData> upload_data)
+      : stream_(stream), upload_data_(upload_data) {}
+
+  const net::UploadDataStream* stream() const { return stream_; }
+  scoped_refptr<UploadData> upload_data() const { return upload_data_; }
+
+ private:
+  // Only used to tell whether the request still uploads the same data.
+  const net::UploadDataStream* stream_;
+  scoped_refptr<UploadData> upload_data_;
+
+  DISALLOW_COPY_AND_ASSIGN(UploadDataUserData);
+};
+
+scoped_refptr<UploadData> GetSharedUploadData(net::URLRequest* request) {
+  // Redirects that turn a POST into a GET drop the upload of the request.
+  const net::UploadDataStream* stream = request->get_upload();
+  auto user_data =
+      static_cast<UploadDataUserData*>(request->GetUserData(kUploadDataKey));
+  if (!user_data || user_data->stream() != stream) {
+    user_data = new UploadDataUserData(stream, UploadData::Create(request));
+    request->SetUserData(kUploadDataKey, user_data);
+  }
+  return user_data->upload_data();
+}
+
 void RunSimpleListener(const AtomNetworkDelegate::SimpleListener& listener,
-                       std::unique_ptr<base::DictionaryValue> details) {
-  return listener.Run(*(details.get()));
+                       std::unique_ptr<base::DictionaryValue> details,
+                       scoped_refptr<UploadData> upload_data) {
+  return listener.Run({ details.get(), upload_data.get() });
 }
 
 void RunResponseListener(
     const AtomNetworkDelegate::ResponseListener& listener,
     std::unique_ptr<base::DictionaryValue> details,
+    scoped_refptr<UploadData> upload_data,
     const AtomNetworkDelegate::ResponseCallback& callback) {
-  return listener.Run(*(details.get()), callback);
+  return listener.Run({ details.get(), upload_data.get() }, callback);
 }
 
 // Test whether the URL of |request| matches |patterns|.
 bool MatchesFilterCondition(net::URLRequest* request,
-                            const URLPatterns& patterns) {
-  if (patterns.empty())
-    return true;
-
-  for (const auto& pattern : patterns) {
-    if (pattern.MatchesURL(request->url()))
-      return true;
-  }
-  return false;
+                            const URLPatternMatcher& patterns) {
+  return patterns.empty() || patterns.Matches(request->url());
 }
 
-// Overloaded by multiple types to fill the |details| object.
-void ToDictionary(base::DictionaryValue* details, net::URLRequest* request) {
-  FillRequestDetails(details, request);
+// Overloaded by multiple types to fill the |details| object, |fields| is the
+// mask of the optional fields to fill.
+void ToDictionary(base::DictionaryValue* details,
+                  int fields,
+                  net::URLRequest* request) {
+  FillRequestInfo(details, request);
   details->SetInteger("id", request->identifier());
   details->SetDouble("timestamp", base::Time::Now().ToDoubleT() * 1000);
   auto info = content::ResourceRequestInfo::ForRequest(request);
@@ -81,7 +118,11 @@ void ToDictionary(base::DictionaryValue* details, net::URLRequest* request) {
 }
 
 void ToDictionary(base::DictionaryValue* details,
+                  int fields,
                   const net::HttpRequestHeaders& headers) {
+  if (!(fields & AtomNetworkDelegate::kRequestHeaders))
+    return;
+
   std::unique_ptr<base::DictionaryValue> dict(new base::DictionaryValue);
   net::HttpRequestHeaders::Iterator it(headers);
   while (it.GetNext())
@@ -90,59 +131,71 @@ void ToDictionary(base::DictionaryValue* details,
 }
 
 void ToDictionary(base::DictionaryValue* details,
+                  int fields,
                   const net::HttpResponseHeaders* headers) {
   if (!headers)
     return;
 
-  std::unique_ptr<base::DictionaryValue> dict(new base::DictionaryValue);
-  size_t iter = 0;
-  std::string key;
-  std::string value;
-  while (headers->EnumerateHeaderLines(&iter, &key, &value)) {
-    if (dict->HasKey(key)) {
-      base::ListValue* values = nullptr;
-      if (dict->GetList(key, &values))
+  if (fields & AtomNetworkDelegate::kResponseHeaders) {
+    std::unique_ptr<base::DictionaryValue> dict(new base::DictionaryValue);
+    size_t iter = 0;
+    std::string key;
+    std::string value;
+    while (headers->EnumerateHeaderLines(&iter, &key, &value)) {
+      if (dict->HasKey(key)) {
+        base::ListValue* values = nullptr;
+        if (dict->GetList(key, &values))
+          values->AppendString(value);
+      } else {
+        std::unique_ptr<base::ListValue> values(new base::ListValue);
         values->AppendString(value);
-    } else {
-      std::unique_ptr<base::ListValue> values(new base::ListValue);
-      values->AppendString(value);
-      dict->Set(key, std::move(values));
+        dict->Set(key, std::move(values));
+      }
     }
+    details->Set("responseHeaders", std::move(dict));
   }
-  details->Set("responseHeaders", std::move(dict));
   details->SetString("statusLine", headers->GetStatusLine());
   details->SetInteger("statusCode", headers->response_code());
 }
 
-void ToDictionary(base::DictionaryValue* details, const GURL& location) {
+void ToDictionary(base::DictionaryValue* details,
+                  int fields,
+                  const GURL& location) {
   details->SetString("redirectURL", location.spec());
 }
 
 void ToDictionary(base::DictionaryValue* details,
+                  int fields,
                   const net::HostPortPair& host_port) {
   if (host_port.host().empty())
     details->SetString("ip", host_port.host());
 }
 
-void ToDictionary(base::DictionaryValue* details, bool from_cache) {
+void ToDictionary(base::DictionaryValue* details,
+                  int fields,
+                  bool from_cache) {
   details->SetBoolean("fromCache", from_cache);
 }
 
 void ToDictionary(base::DictionaryValue* details,
+                  int fields,
                   const net::URLRequestStatus& status) {
   details->SetString("error", net::ErrorToString(status.error()));
 }
 
 // Helper function to fill |details| with arbitrary |args|.
 template<typename Arg>
-void FillDetailsObject(base::DictionaryValue* details, Arg arg) {
-  ToDictionary(details, arg);
+void FillDetailsObject(base::DictionaryValue* details, int fields, Arg arg) {
+  ToDictionary(details, fields, arg);
 }
 
 template<typename Arg, typename... Args>
-void FillDetailsObject(base::DictionaryValue* details, Arg arg, Args... args) {
-  ToDictionary(details, arg);
-  FillDetailsObject(details, args...);
+void FillDetailsObject(base::DictionaryValue* details,
+                       int fields,
+                       Arg arg,
+                       Args... args) {
+  ToDictionary(details, fields, arg);
+  FillDetailsObject(details, fields, args...);
 }
 
 // Fill the native types with the result from the response object.
@@ -205,21 +258,31 @@ AtomNetworkDelegate::~AtomNetworkDelegate() {
 void AtomNetworkDelegate::SetSimpleListenerInIO(
     SimpleEvent type,
     const URLPatterns& patterns,
+    int fields,
     const SimpleListener& callback) {
   if (callback.is_null())
     simple_listeners_.erase(type);
   else
-    simple_listeners_[type] = { patterns, callback };
+    simple_listeners_[type] = { URLPatternMatcher(patterns), fields, callback };
 }
 
 void AtomNetworkDelegate::SetResponseListenerInIO(
     ResponseEvent type,
     const URLPatterns& patterns,
+    int fields,
     const ResponseListener& callback) {
   if (callback.is_null())
     response_listeners_.erase(type);
   else
-    response_listeners_[type] = { patterns, callback };
+    response_listeners_[type] = {
+        URLPatternMatcher(patterns), fields, callback };
+}
+
+void AtomNetworkDelegate::SetRulesInIO(
+    std::unique_ptr<WebRequestRules> rules) {
+  if (rules && rules->empty())
+    rules.reset();
+  rules_ = std::move(rules);
 }
 
 void AtomNetworkDelegate::SetDevToolsNetworkEmulationClientId(
@@ -232,6 +295,10 @@ int AtomNetworkDelegate::OnBeforeURLRequest(
     net::URLRequest* request,
     const net::CompletionCallback& callback,
     GURL* new_url) {
+  int result = net::OK;
+  if (rules_ && rules_->OnBeforeRequest(request, new_url, &result))
+    return result;
+
   if (!base::ContainsKey(response_listeners_, kOnBeforeRequest))
     return brightray::NetworkDelegate::OnBeforeURLRequest(
         request, callback, new_url);
@@ -253,7 +320,8 @@ int AtomNetworkDelegate::OnBeforeStartTransaction(
     headers->SetHeader(
         DevToolsNetworkTransaction::kDevToolsEmulateNetworkConditionsClientId,
         client_id);
-  if (!base::ContainsKey(response_listeners_, kOnBeforeSendHeaders))
+  if ((rules_ && rules_->OnBeforeSendHeaders(request, headers)) ||
+      !base::ContainsKey(response_listeners_, kOnBeforeSendHeaders))
     return brightray::NetworkDelegate::OnBeforeStartTransaction(
         request, callback, headers);
 
@@ -278,7 +346,8 @@ int AtomNetworkDelegate::OnHeadersReceived(
     const net::HttpResponseHeaders* original,
     scoped_refptr<net::HttpResponseHeaders>* override,
     GURL* allowed) {
-  if (!base::ContainsKey(response_listeners_, kOnHeadersReceived))
+  if ((rules_ && rules_->OnHeadersReceived(request, original, override)) ||
+      !base::ContainsKey(response_listeners_, kOnHeadersReceived))
     return brightray::NetworkDelegate::OnHeadersReceived(
         request, callback, original, override, allowed);
 
@@ -365,7 +434,10 @@ int AtomNetworkDelegate::HandleResponseEvent(
     return net::OK;
 
   std::unique_ptr<base::DictionaryValue> details(new base::DictionaryValue);
-  FillDetailsObject(details.get(), request, args...);
+  FillDetailsObject(details.get(), info.fields, request, args...);
+  scoped_refptr<UploadData> upload_data;
+  if (info.fields & kUploadData)
+    upload_data = GetSharedUploadData(request);
 
   // The |request| could be destroyed before the |callback| is called.
   callbacks_[request->identifier()] = callback;
@@ -376,7 +448,7 @@ int AtomNetworkDelegate::HandleResponseEvent(
   BrowserThread::PostTask(
       BrowserThread::UI, FROM_HERE,
       base::Bind(RunResponseListener, info.listener, base::Passed(&details),
-                 response));
+                 upload_data, response));
   return net::ERR_IO_PENDING;
 }
 
@@ -388,11 +460,15 @@ void AtomNetworkDelegate::HandleSimpleEvent(
     return;
 
   std::unique_ptr<base::DictionaryValue> details(new base::DictionaryValue);
-  FillDetailsObject(details.get(), request, args...);
+  FillDetailsObject(details.get(), info.fields, request, args...);
+  scoped_refptr<UploadData> upload_data;
+  if (info.fields & kUploadData)
+    upload_data = GetSharedUploadData(request);
 
   BrowserThread::PostTask(
       BrowserThread::UI, FROM_HERE,
-      base::Bind(RunSimpleListener, info.listener, base::Passed(&details)));
+      base::Bind(RunSimpleListener, info.listener, base::Passed(&details),
+                 upload_data));
 }
 
 template<typename T>
@@ -412,7 +488,14 @@ void AtomNetworkDelegate::OnListenerResultInIO(
 template<typename T>
 void AtomNetworkDelegate::OnListenerResultInUI(
     uint64_t id, T out, const base::DictionaryValue& response) {
-  std::unique_ptr<base::DictionaryValue> copy = response.CreateDeepCopy();
+  // Only copy what is read from the response, listeners often pass back the
+  // whole details object.
+  std::unique_ptr<base::DictionaryValue> copy(new base::DictionaryValue);
+  for (const char* key : kResponseKeys) {
+    const base::Value* value;
+    if (response.GetWithoutPathExpansion(key, &value))
+      copy->SetWithoutPathExpansion(key, value->CreateDeepCopy());
+  }
   BrowserThread::PostTask(
       BrowserThread::IO, FROM_HERE,
       base::Bind(&AtomNetworkDelegate::OnListenerResultInIO<T>,
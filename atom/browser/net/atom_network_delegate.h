@@ -6,9 +6,11 @@
 #define ATOM_BROWSER_NET_ATOM_NETWORK_DELEGATE_H_
 
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 
+#include "atom/browser/net/url_pattern_matcher.h"
 #include "base/callback.h"
 #include "base/synchronization/lock.h"
 #include "base/values.h"
@@ -23,17 +25,37 @@ class URLPattern;
 
 namespace atom {
 
+class UploadData;
+class WebRequestRules;
+
 using URLPatterns = std::set<URLPattern>;
 
 const char* ResourceTypeToString(content::ResourceType type);
 
 class AtomNetworkDelegate : public brightray::NetworkDelegate {
  public:
+  // The details passed to listeners, the upload data is kept apart so its
+  // bytes can be shared instead of copied into |dict|.
+  struct ListenerDetails {
+    const base::DictionaryValue* dict;
+    // May be null.
+    const UploadData* upload_data;
+  };
+
   using ResponseCallback = base::Callback<void(const base::DictionaryValue&)>;
-  using SimpleListener = base::Callback<void(const base::DictionaryValue&)>;
-  using ResponseListener = base::Callback<void(const base::DictionaryValue&,
+  using SimpleListener = base::Callback<void(const ListenerDetails&)>;
+  using ResponseListener = base::Callback<void(const ListenerDetails&,
                                                const ResponseCallback&)>;
 
+  // The fields of the details that are only built for listeners asking for
+  // them.
+  enum DetailsField {
+    kUploadData = 1 << 0,
+    kRequestHeaders = 1 << 1,
+    kResponseHeaders = 1 << 2,
+    kAllDetailsFields = kUploadData | kRequestHeaders | kResponseHeaders,
+  };
+
   enum SimpleEvent {
     kOnSendHeaders,
     kOnBeforeRedirect,
@@ -49,25 +71,33 @@ class AtomNetworkDelegate : public brightray::NetworkDelegate {
   };
 
   struct SimpleListenerInfo {
-    URLPatterns url_patterns;
+    URLPatternMatcher url_patterns;
+    int fields;
     SimpleListener listener;
   };
 
   struct ResponseListenerInfo {
-    URLPatterns url_patterns;
+    URLPatternMatcher url_patterns;
+    int fields;
     ResponseListener listener;
   };
 
   AtomNetworkDelegate();
   ~AtomNetworkDelegate() override;
 
+  // |fields| is a mask of DetailsField.
   void SetSimpleListenerInIO(SimpleEvent type,
                              const URLPatterns& patterns,
+                             int fields,
                              const SimpleListener& callback);
   void SetResponseListenerInIO(ResponseEvent type,
                                const URLPatterns& patterns,
+                               int fields,
                                const ResponseListener& callback);
 
+  // Replaces the declarative rules, null removes them.
+  void SetRulesInIO(std::unique_ptr<WebRequestRules> rules);
+
   void SetDevToolsNetworkEmulationClientId(const std::string& client_id);
 
  protected:
@@ -118,6 +148,9 @@ class AtomNetworkDelegate : public brightray::NetworkDelegate {
   std::map<ResponseEvent, ResponseListenerInfo> response_listeners_;
   std::map<uint64_t, net::CompletionCallback> callbacks_;
 
+  // Requests handled by a rule skip the listener of the same event.
+  std::unique_ptr<WebRequestRules> rules_;
+
   base::Lock lock_;
 
   // Client id for devtools network emulation.
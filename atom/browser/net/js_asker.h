@@ -5,6 +5,7 @@
 #ifndef ATOM_BROWSER_NET_JS_ASKER_H_
 #define ATOM_BROWSER_NET_JS_ASKER_H_
 
+#include "atom/browser/net/protocol_response_cache.h"
 #include "atom/common/native_mate_converters/net_converter.h"
 #include "base/callback.h"
 #include "base/memory/ref_counted.h"
@@ -13,6 +14,7 @@
 #include "content/public/browser/browser_thread.h"
 #include "net/base/net_errors.h"
 #include "net/http/http_response_headers.h"
+#include "net/http/http_status_code.h"
 #include "net/url_request/url_request_context_getter.h"
 #include "net/url_request/url_request_job.h"
 #include "v8/include/v8.h"
@@ -29,10 +31,12 @@ using BeforeStartCallback =
 using ResponseCallback =
     base::Callback<void(bool, std::unique_ptr<base::Value> options)>;
 
-// Ask handler for options in UI thread.
+// Ask handler for options in UI thread. When |convert_options| is false an
+// empty dictionary is passed to |callback| instead of the converted options.
 void AskForOptions(v8::Isolate* isolate,
                    const JavaScriptHandler& handler,
                    std::unique_ptr<base::DictionaryValue> request_details,
+                   bool convert_options,
                    const BeforeStartCallback& before_start,
                    const ResponseCallback& callback);
 
@@ -47,6 +51,9 @@ class JsAsker : public RequestJob {
   JsAsker(net::URLRequest* request, net::NetworkDelegate* network_delegate)
       : RequestJob(request, network_delegate), weak_factory_(this) {}
 
+  // Whether the job implements StartFromCache, subclasses that do hide this.
+  static const bool kSupportsResponseCache = false;
+
   // Called by |CustomProtocolHandler| to store handler related information.
   void SetHandlerInfo(
       v8::Isolate* isolate,
@@ -57,26 +64,62 @@ class JsAsker : public RequestJob {
     handler_ = handler;
   }
 
+  // Called by |CustomProtocolHandler| when the protocol was registered with
+  // a response cache.
+  void SetResponseCache(ProtocolResponseCache* response_cache) {
+    response_cache_ = response_cache;
+  }
+
   // Subclass should do initailze work here.
   virtual void BeforeStartInUI(v8::Isolate*, v8::Local<v8::Value>) {}
   virtual void StartAsync(std::unique_ptr<base::Value> options) = 0;
 
+  // Subclasses reading everything they need in BeforeStartInUI can skip the
+  // conversion of the value passed by the handler.
+  virtual bool ShouldConvertOptions() const { return true; }
+
+  // Subclasses able to serve a cached response start the job with |entry|
+  // here, the handler is asked when it returns false.
+  virtual bool StartFromCache(const ProtocolResponseCache::Entry& entry) {
+    return false;
+  }
+
   net::URLRequestContextGetter* request_context_getter() const {
     return request_context_getter_;
   }
 
+  ProtocolResponseCache* response_cache() const {
+    return response_cache_.get();
+  }
+
  private:
   // RequestJob:
   void Start() override {
+    if (response_cache_) {
+      cached_response_ = response_cache_->Get(RequestJob::request());
+      if (cached_response_ && cached_response_->IsFresh() &&
+          StartFromCache(*cached_response_))
+        return;
+    }
+
     std::unique_ptr<base::DictionaryValue> request_details(
         new base::DictionaryValue);
     FillRequestDetails(request_details.get(), RequestJob::request());
+    // Let the handler confirm the stale response is still valid.
+    if (cached_response_ && !cached_response_->etag().empty()) {
+      std::unique_ptr<base::DictionaryValue> headers(
+          new base::DictionaryValue);
+      headers->SetStringWithoutPathExpansion("If-None-Match",
+                                             cached_response_->etag());
+      request_details->Set("headers", std::move(headers));
+    }
     content::BrowserThread::PostTask(
         content::BrowserThread::UI, FROM_HERE,
         base::Bind(&internal::AskForOptions,
                    isolate_,
                    handler_,
                    base::Passed(&request_details),
+                   ShouldConvertOptions(),
                    base::Bind(&JsAsker::BeforeStartInUI,
                               weak_factory_.GetWeakPtr()),
                    base::Bind(&JsAsker::OnResponse,
@@ -91,6 +134,13 @@ class JsAsker : public RequestJob {
   void OnResponse(bool success, std::unique_ptr<base::Value> value) {
     int error = net::ERR_NOT_IMPLEMENTED;
     if (success && value && !internal::IsErrorOptions(value.get(), &error)) {
+      if (IsNotModified(*value)) {
+        cached_response_ = response_cache_->Revalidate(
+            RequestJob::request(), cached_response_,
+            static_cast<const base::DictionaryValue&>(*value));
+        if (StartFromCache(*cached_response_))
+          return;
+      }
       StartAsync(std::move(value));
     } else {
       RequestJob::NotifyStartError(
@@ -98,9 +148,22 @@ class JsAsker : public RequestJob {
     }
   }
 
+  // Whether the handler answered the revalidation of |cached_response_|
+  // with a 304 status.
+  bool IsNotModified(const base::Value& value) const {
+    const base::DictionaryValue* dict;
+    int status_code;
+    return cached_response_ && value.GetAsDictionary(&dict) &&
+           dict->GetInteger("statusCode", &status_code) &&
+           status_code == net::HTTP_NOT_MODIFIED;
+  }
+
   v8::Isolate* isolate_;
   net::URLRequestContextGetter* request_context_getter_;
   JavaScriptHandler handler_;
+  scoped_refptr<ProtocolResponseCache> response_cache_;
+  // The stored response of the request, may be stale.
+  scoped_refptr<ProtocolResponseCache::Entry> cached_response_;
 
   base::WeakPtrFactory<JsAsker> weak_factory_;
 
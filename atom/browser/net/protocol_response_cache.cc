@@ -0,0 +1,188 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/protocol_response_cache.h"
+
+#include <string>
+#include <vector>
+
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "base/values.h"
+#include "net/http/http_util.h"
+#include "net/url_request/url_request.h"
+
+namespace atom {
+
+namespace {
+
+const char kCacheControl[] = "Cache-Control";
+const char kETag[] = "ETag";
+
+// Only responses to requests without side effects are cached.
+bool GetCacheKey(const net::URLRequest* request, std::string* key) {
+  const std::string& method = request->method();
+  if ((method != "GET" && method != "HEAD") || request->has_upload())
+    return false;
+  *key = method + " " + request->url().spec();
+  return true;
+}
+
+// Returns how long a response with |cache_control| may be served without
+// asking the handler, false when it must not be stored at all.
+bool GetMaxAge(const std::string& cache_control,
+               bool has_etag,
+               base::TimeDelta* max_age) {
+  bool has_max_age = false;
+  bool no_cache = false;
+  for (const std::string& directive : base::SplitString(
+           cache_control, ",", base::TRIM_WHITESPACE,
+           base::SPLIT_WANT_NONEMPTY)) {
+    int64_t seconds;
+    if (base::LowerCaseEqualsASCII(directive, "no-store")) {
+      return false;
+    } else if (base::LowerCaseEqualsASCII(directive, "no-cache")) {
+      no_cache = true;
+    } else if (base::StartsWith(directive, "max-age=",
+                                base::CompareCase::INSENSITIVE_ASCII) &&
+               base::StringToInt64(directive.substr(8), &seconds) &&
+               seconds >= 0) {
+      has_max_age = true;
+      *max_age = base::TimeDelta::FromSeconds(seconds);
+    }
+  }
+
+  if (no_cache || !has_max_age)
+    *max_age = base::TimeDelta();
+  // A response that is always stale is only useful for revalidation.
+  return has_etag || !max_age->is_zero();
+}
+
+}  // namespace
+
+ProtocolResponseCache::Entry::Entry(
+    const std::string& mime_type,
+    const std::string& charset,
+    scoped_refptr<base::RefCountedMemory> data,
+    const std::string& cache_control,
+    const std::string& etag)
+    : mime_type_(mime_type),
+      charset_(charset),
+      data_(data),
+      cache_control_(cache_control),
+      etag_(etag) {
+}
+
+ProtocolResponseCache::Entry::~Entry() {
+}
+
+bool ProtocolResponseCache::Entry::IsFresh() const {
+  return base::Time::Now() < expiry_;
+}
+
+size_t ProtocolResponseCache::Entry::size() const {
+  return (data_ ? data_->size() : 0) + mime_type_.size() + charset_.size() +
+         cache_control_.size() + etag_.size();
+}
+
+ProtocolResponseCache::ProtocolResponseCache(size_t max_size)
+    : max_size_(max_size),
+      size_(0),
+      entries_(EntryMap::NO_AUTO_EVICT) {
+}
+
+ProtocolResponseCache::~ProtocolResponseCache() {
+}
+
+scoped_refptr<ProtocolResponseCache::Entry> ProtocolResponseCache::Get(
+    const net::URLRequest* request) {
+  std::string key;
+  if (!GetCacheKey(request, &key))
+    return nullptr;
+  auto it = entries_.Get(key);
+  if (it == entries_.end())
+    return nullptr;
+  return it->second;
+}
+
+void ProtocolResponseCache::Put(const net::URLRequest* request,
+                                scoped_refptr<Entry> entry) {
+  std::string key;
+  if (!GetCacheKey(request, &key))
+    return;
+
+  auto it = entries_.Peek(key);
+  if (it != entries_.end()) {
+    size_ -= key.size() + it->second->size();
+    entries_.Erase(it);
+  }
+
+  base::TimeDelta max_age;
+  if (!GetMaxAge(entry->cache_control(), !entry->etag().empty(), &max_age))
+    return;
+  size_t size = key.size() + entry->size();
+  if (size > max_size_)
+    return;
+
+  entry->expiry_ = base::Time::Now() + max_age;
+  entries_.Put(key, entry);
+  size_ += size;
+  EvictIfNeeded();
+}
+
+scoped_refptr<ProtocolResponseCache::Entry> ProtocolResponseCache::Revalidate(
+    const net::URLRequest* request,
+    scoped_refptr<Entry> entry,
+    const base::DictionaryValue& options) {
+  std::string cache_control, etag;
+  // Keep serving the stale entry, but do not store it again.
+  if (!GetCachingHeaders(options, &cache_control, &etag))
+    return entry;
+  if (cache_control.empty() && etag.empty()) {
+    cache_control = entry->cache_control();
+    etag = entry->etag();
+  }
+  // Entries are shared with the jobs serving them, so store a new one.
+  scoped_refptr<Entry> refreshed(new Entry(
+      entry->mime_type(), entry->charset(), entry->data(), cache_control,
+      etag));
+  Put(request, refreshed);
+  return refreshed;
+}
+
+// static
+bool ProtocolResponseCache::GetCachingHeaders(
+    const base::DictionaryValue& options,
+    std::string* cache_control,
+    std::string* etag) {
+  const base::DictionaryValue* headers;
+  if (!options.GetDictionary("headers", &headers))
+    return true;
+  for (base::DictionaryValue::Iterator it(*headers); !it.IsAtEnd();
+       it.Advance()) {
+    if (base::EqualsCaseInsensitiveASCII(it.key(), kCacheControl))
+      it.value().GetAsString(cache_control);
+    else if (base::EqualsCaseInsensitiveASCII(it.key(), kETag))
+      it.value().GetAsString(etag);
+  }
+  // The headers are added to the response, which they must not break.
+  if (!net::HttpUtil::IsValidHeaderValue(*cache_control) ||
+      !net::HttpUtil::IsValidHeaderValue(*etag)) {
+    cache_control->clear();
+    etag->clear();
+    return false;
+  }
+  return true;
+}
+
+void ProtocolResponseCache::EvictIfNeeded() {
+  while (size_ > max_size_ && !entries_.empty()) {
+    auto it = entries_.rbegin();
+    size_ -= it->first.size() + it->second->size();
+    entries_.Erase(it);
+  }
+}
+
+}  // namespace atom
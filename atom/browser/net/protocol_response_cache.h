@@ -0,0 +1,110 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_PROTOCOL_RESPONSE_CACHE_H_
+#define ATOM_BROWSER_NET_PROTOCOL_RESPONSE_CACHE_H_
+
+#include <string>
+
+#include "base/containers/mru_cache.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/time/time.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace net {
+class URLRequest;
+}
+
+namespace atom {
+
+// Keeps the responses of a protocol handler in memory, so repeated requests
+// can be served on the IO thread without asking the handler again. Responses
+// are keyed by method and URL, and only kept when the handler allowed it with
+// the Cache-Control or ETag headers. The least recently used responses are
+// evicted to stay within the byte budget. Only used on the IO thread.
+class ProtocolResponseCache : public base::RefCounted<ProtocolResponseCache> {
+ public:
+  // A cached response, never modified once stored.
+  class Entry : public base::RefCounted<Entry> {
+   public:
+    Entry(const std::string& mime_type,
+          const std::string& charset,
+          scoped_refptr<base::RefCountedMemory> data,
+          const std::string& cache_control,
+          const std::string& etag);
+
+    // Whether the entry can be served without asking the handler.
+    bool IsFresh() const;
+
+    const std::string& mime_type() const { return mime_type_; }
+    const std::string& charset() const { return charset_; }
+    scoped_refptr<base::RefCountedMemory> data() const { return data_; }
+    const std::string& cache_control() const { return cache_control_; }
+    const std::string& etag() const { return etag_; }
+
+   private:
+    friend class base::RefCounted<Entry>;
+    friend class ProtocolResponseCache;
+
+    ~Entry();
+
+    size_t size() const;
+
+    std::string mime_type_;
+    std::string charset_;
+    scoped_refptr<base::RefCountedMemory> data_;
+    std::string cache_control_;
+    std::string etag_;
+    base::Time expiry_;
+
+    DISALLOW_COPY_AND_ASSIGN(Entry);
+  };
+
+  explicit ProtocolResponseCache(size_t max_size);
+
+  // Returns the response stored for |request|, which may be stale, or null.
+  scoped_refptr<Entry> Get(const net::URLRequest* request);
+
+  // Stores |entry| as the response to |request|, replacing the previous one.
+  // Nothing is stored when the headers of |entry| do not allow caching.
+  void Put(const net::URLRequest* request, scoped_refptr<Entry> entry);
+
+  // Stores |entry| again after the handler confirmed it is still valid, with
+  // the caching headers of the handler's |options| when it sent new ones.
+  // Returns the refreshed entry.
+  scoped_refptr<Entry> Revalidate(const net::URLRequest* request,
+                                  scoped_refptr<Entry> entry,
+                                  const base::DictionaryValue& options);
+
+  // Reads the Cache-Control and ETag headers from the |options| returned by
+  // a protocol handler. Both are left empty and false is returned when one of
+  // them is not a valid header value, so the response is not cached.
+  static bool GetCachingHeaders(const base::DictionaryValue& options,
+                                std::string* cache_control,
+                                std::string* etag);
+
+ private:
+  friend class base::RefCounted<ProtocolResponseCache>;
+
+  using EntryMap = base::MRUCache<std::string, scoped_refptr<Entry>>;
+
+  ~ProtocolResponseCache();
+
+  // Drops the least recently used entries until |size_| fits the budget.
+  void EvictIfNeeded();
+
+  size_t max_size_;
+  size_t size_;
+  EntryMap entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(ProtocolResponseCache);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_PROTOCOL_RESPONSE_CACHE_H_
@@ -0,0 +1,258 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/url_pattern_matcher.h"
+
+#include <algorithm>
+#include <queue>
+
+#include "url/gurl.h"
+#include "url/url_constants.h"
+
+namespace atom {
+
+namespace {
+
+// URLPattern ignores a trailing dot of hosts.
+std::string CanonicalizeHost(const std::string& host) {
+  if (!host.empty() && host.back() == '.')
+    return host.substr(0, host.size() - 1);
+  return host;
+}
+
+// Returns the longest part of |path| without wildcards, which must appear in
+// the path of every URL matching it.
+std::string GetPathLiteral(const URLPattern& pattern) {
+  std::string path = pattern.path();
+  // "/foo/*" also matches "/foo", so its "/" is not required.
+  if (path.size() >= 2 && path.compare(path.size() - 2, 2, "/*") == 0)
+    path.resize(path.size() - 2);
+
+  std::string literal;
+  size_t start = 0;
+  while (start <= path.size()) {
+    size_t end = path.find('*', start);
+    if (end == std::string::npos)
+      end = path.size();
+    if (end - start > literal.size())
+      literal = path.substr(start, end - start);
+    start = end + 1;
+  }
+  return literal;
+}
+
+}  // namespace
+
+URLPatternMatcher::PathNode::PathNode() : fail(0) {
+}
+
+URLPatternMatcher::PathNode::PathNode(const PathNode& other) = default;
+
+URLPatternMatcher::PathNode::~PathNode() {
+}
+
+URLPatternMatcher::Bucket::Bucket() : path_nodes(1) {
+}
+
+URLPatternMatcher::Bucket::Bucket(const Bucket& other) = default;
+
+URLPatternMatcher::Bucket::~Bucket() {
+}
+
+URLPatternMatcher::URLPatternMatcher() {
+}
+
+URLPatternMatcher::URLPatternMatcher(const std::set<URLPattern>& patterns)
+    : patterns_(patterns.begin(), patterns.end()),
+      ids_(patterns.size(), 0) {
+  Build();
+}
+
+URLPatternMatcher::URLPatternMatcher(
+    const std::vector<std::pair<URLPattern, int>>& patterns) {
+  for (const auto& pattern : patterns) {
+    patterns_.push_back(pattern.first);
+    ids_.push_back(pattern.second);
+  }
+  Build();
+}
+
+URLPatternMatcher::URLPatternMatcher(const URLPatternMatcher& other) = default;
+
+URLPatternMatcher::~URLPatternMatcher() {
+}
+
+URLPatternMatcher& URLPatternMatcher::operator=(
+    const URLPatternMatcher& other) = default;
+
+bool URLPatternMatcher::Matches(const GURL& url) const {
+  return Match(url, nullptr);
+}
+
+void URLPatternMatcher::GetMatches(const GURL& url, std::set<int>* ids) const {
+  Match(url, ids);
+}
+
+void URLPatternMatcher::Build() {
+  for (size_t i = 0; i < patterns_.size(); ++i) {
+    const URLPattern& pattern = patterns_[i];
+    int index = static_cast<int>(i);
+    if (pattern.match_all_urls()) {
+      all_urls_.push_back(index);
+      continue;
+    }
+
+    Bucket* bucket = &buckets_[pattern.scheme()];
+    // Hosts are ignored for file URLs.
+    bool any_host = pattern.scheme() == url::kFileScheme ||
+                    (pattern.match_subdomains() && pattern.host().empty());
+    if (!any_host) {
+      std::string host = CanonicalizeHost(pattern.host());
+      if (pattern.match_subdomains())
+        bucket->subdomain_hosts[host].push_back(index);
+      else
+        bucket->exact_hosts[host].push_back(index);
+      continue;
+    }
+
+    std::string literal = GetPathLiteral(pattern);
+    if (literal.empty())
+      bucket->any_path.push_back(index);
+    else
+      AddPathLiteral(bucket, literal, index);
+  }
+
+  for (auto& bucket : buckets_)
+    BuildFailLinks(&bucket.second);
+}
+
+void URLPatternMatcher::AddPathLiteral(Bucket* bucket,
+                                       const std::string& literal,
+                                       int index) {
+  int node = 0;
+  for (char c : literal) {
+    auto it = bucket->path_nodes[node].next.find(c);
+    if (it != bucket->path_nodes[node].next.end()) {
+      node = it->second;
+    } else {
+      int child = static_cast<int>(bucket->path_nodes.size());
+      bucket->path_nodes[node].next[c] = child;
+      bucket->path_nodes.emplace_back();
+      node = child;
+    }
+  }
+  bucket->path_nodes[node].patterns.push_back(index);
+}
+
+void URLPatternMatcher::BuildFailLinks(Bucket* bucket) {
+  std::vector<PathNode>& nodes = bucket->path_nodes;
+  // Breadth first, so the fail link of a node is done before its children.
+  std::queue<int> queue;
+  for (const auto& edge : nodes[0].next)
+    queue.push(edge.second);
+  while (!queue.empty()) {
+    int node = queue.front();
+    queue.pop();
+    for (const auto& edge : nodes[node].next) {
+      int fail = nodes[node].fail;
+      while (fail != 0 && !nodes[fail].next.count(edge.first))
+        fail = nodes[fail].fail;
+      auto it = nodes[fail].next.find(edge.first);
+      int child = edge.second;
+      nodes[child].fail =
+          it != nodes[fail].next.end() && it->second != child ? it->second
+                                                              : 0;
+      const std::vector<int>& inherited = nodes[nodes[child].fail].patterns;
+      nodes[child].patterns.insert(nodes[child].patterns.end(),
+                                   inherited.begin(), inherited.end());
+      queue.push(child);
+    }
+  }
+}
+
+bool URLPatternMatcher::Match(const GURL& url, std::set<int>* ids) const {
+  if (patterns_.empty())
+    return false;
+
+  std::vector<int> candidates;
+  if (url.inner_url()) {
+    // Nested URLs are matched by their inner URL, just test all patterns.
+    candidates.resize(patterns_.size());
+    for (size_t i = 0; i < patterns_.size(); ++i)
+      candidates[i] = static_cast<int>(i);
+  } else {
+    candidates = all_urls_;
+    std::string host = CanonicalizeHost(url.host());
+    std::string path = url.PathForRequest();
+    auto it = buckets_.find(url.scheme());
+    if (it != buckets_.end())
+      CollectCandidates(it->second, host, path, &candidates);
+    it = buckets_.find("*");
+    if (it != buckets_.end())
+      CollectCandidates(it->second, host, path, &candidates);
+
+    // A literal can be found more than once in the path.
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                     candidates.end());
+  }
+
+  bool matched = false;
+  for (int index : candidates) {
+    if (ids && ids->count(ids_[index]))
+      continue;
+    if (!patterns_[index].MatchesURL(url))
+      continue;
+    matched = true;
+    if (!ids)
+      break;
+    ids->insert(ids_[index]);
+  }
+  return matched;
+}
+
+void URLPatternMatcher::CollectCandidates(const Bucket& bucket,
+                                          const std::string& host,
+                                          const std::string& path,
+                                          std::vector<int>* candidates) const {
+  auto exact = bucket.exact_hosts.find(host);
+  if (exact != bucket.exact_hosts.end())
+    candidates->insert(candidates->end(), exact->second.begin(),
+                       exact->second.end());
+
+  // Look up the host and each of its parent domains.
+  if (!bucket.subdomain_hosts.empty()) {
+    size_t start = 0;
+    while (start != std::string::npos) {
+      auto suffix = bucket.subdomain_hosts.find(host.substr(start));
+      if (suffix != bucket.subdomain_hosts.end())
+        candidates->insert(candidates->end(), suffix->second.begin(),
+                           suffix->second.end());
+      start = host.find('.', start);
+      if (start != std::string::npos)
+        ++start;
+    }
+  }
+
+  candidates->insert(candidates->end(), bucket.any_path.begin(),
+                     bucket.any_path.end());
+
+  const std::vector<PathNode>& nodes = bucket.path_nodes;
+  if (nodes.size() == 1)
+    return;
+  int node = 0;
+  for (char c : path) {
+    auto it = nodes[node].next.find(c);
+    while (node != 0 && it == nodes[node].next.end()) {
+      node = nodes[node].fail;
+      it = nodes[node].next.find(c);
+    }
+    if (it != nodes[node].next.end())
+      node = it->second;
+    candidates->insert(candidates->end(), nodes[node].patterns.begin(),
+                       nodes[node].patterns.end());
+  }
+}
+
+}  // namespace atom
@@ -0,0 +1,96 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_URL_PATTERN_MATCHER_H_
+#define ATOM_BROWSER_NET_URL_PATTERN_MATCHER_H_
+
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "extensions/common/url_pattern.h"
+
+class GURL;
+
+namespace atom {
+
+// Matches URLs against a large set of URLPatterns without testing each one.
+//
+// Patterns are bucketed by scheme, then by host, and URLs only look up the
+// buckets of their own host and its parent domains. Patterns matching any
+// host are found by the longest literal part of their paths, which are all
+// searched in one Aho-Corasick pass over the URL's path. The candidates are
+// then checked with URLPattern::MatchesURL, so the results are the same with
+// testing every pattern.
+class URLPatternMatcher {
+ public:
+  URLPatternMatcher();
+  // Every pattern gets the id 0.
+  explicit URLPatternMatcher(const std::set<URLPattern>& patterns);
+  explicit URLPatternMatcher(
+      const std::vector<std::pair<URLPattern, int>>& patterns);
+  URLPatternMatcher(const URLPatternMatcher& other);
+  ~URLPatternMatcher();
+
+  URLPatternMatcher& operator=(const URLPatternMatcher& other);
+
+  // Whether any pattern matches |url|.
+  bool Matches(const GURL& url) const;
+
+  // Adds the ids of all patterns matching |url| to |ids|.
+  void GetMatches(const GURL& url, std::set<int>* ids) const;
+
+  bool empty() const { return patterns_.empty(); }
+
+ private:
+  // Aho-Corasick automaton over the literal parts of path patterns.
+  struct PathNode {
+    PathNode();
+    PathNode(const PathNode& other);
+    ~PathNode();
+
+    std::map<char, int> next;
+    int fail;
+    // Patterns whose literal ends here, including those of the fail links.
+    std::vector<int> patterns;
+  };
+
+  struct Bucket {
+    Bucket();
+    Bucket(const Bucket& other);
+    ~Bucket();
+
+    std::unordered_map<std::string, std::vector<int>> exact_hosts;
+    std::unordered_map<std::string, std::vector<int>> subdomain_hosts;
+    // Patterns matching any host, with and without a path literal.
+    std::vector<PathNode> path_nodes;
+    std::vector<int> any_path;
+  };
+
+  void Build();
+  void AddPathLiteral(Bucket* bucket, const std::string& literal, int index);
+  void BuildFailLinks(Bucket* bucket);
+
+  // Stops at the first match when |ids| is null.
+  bool Match(const GURL& url, std::set<int>* ids) const;
+  void CollectCandidates(const Bucket& bucket,
+                         const std::string& host,
+                         const std::string& path,
+                         std::vector<int>* candidates) const;
+
+  std::vector<URLPattern> patterns_;
+  std::vector<int> ids_;
+
+  // Keyed by scheme, "*" holds patterns of any scheme.
+  std::map<std::string, Bucket> buckets_;
+  // <all_urls> patterns.
+  std::vector<int> all_urls_;
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_URL_PATTERN_MATCHER_H_
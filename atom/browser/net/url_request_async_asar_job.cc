@@ -6,7 +6,6 @@
 
 #include <string>
 
-#include "atom/common/atom_constants.h"
 #include "base/threading/sequenced_worker_pool.h"
 
 namespace atom {
@@ -39,12 +38,4 @@ void URLRequestAsyncAsarJob::StartAsync(std::unique_ptr<base::Value> options) {
   }
 }
 
-void URLRequestAsyncAsarJob::GetResponseInfo(net::HttpResponseInfo* info) {
-  std::string status("HTTP/1.1 200 OK");
-  auto* headers = new net::HttpResponseHeaders(status);
-
-  headers->AddHeader(kCORSHeader);
-  info->headers = headers;
-}
-
 }  // namespace atom
@@ -18,9 +18,6 @@ class URLRequestAsyncAsarJob : public JsAsker<asar::URLRequestAsarJob> {
   // JsAsker:
   void StartAsync(std::unique_ptr<base::Value> options) override;
 
-  // URLRequestJob:
-  void GetResponseInfo(net::HttpResponseInfo* info) override;
-
  private:
   DISALLOW_COPY_AND_ASSIGN(URLRequestAsyncAsarJob);
 };
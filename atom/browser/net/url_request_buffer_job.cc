@@ -40,6 +40,7 @@ void URLRequestBufferJob::StartAsync(std::unique_ptr<base::Value> options) {
     dict->GetString("mimeType", &mime_type_);
     dict->GetString("charset", &charset_);
     dict->GetBinary("data", &binary);
+    ProtocolResponseCache::GetCachingHeaders(*dict, &cache_control_, &etag_);
   } else if (options->IsType(base::Value::Type::BINARY)) {
     options->GetAsBinary(&binary);
   }
@@ -63,7 +64,23 @@ void URLRequestBufferJob::StartAsync(std::unique_ptr<base::Value> options) {
       reinterpret_cast<const unsigned char*>(binary->GetBuffer()),
       binary->GetSize());
   status_code_ = net::HTTP_OK;
+  if (response_cache()) {
+    response_cache()->Put(request(), new ProtocolResponseCache::Entry(
+        mime_type_, charset_, data_, cache_control_, etag_));
+  }
+  net::URLRequestSimpleJob::Start();
+}
+
+bool URLRequestBufferJob::StartFromCache(
+    const ProtocolResponseCache::Entry& entry) {
+  mime_type_ = entry.mime_type();
+  charset_ = entry.charset();
+  data_ = entry.data();
+  cache_control_ = entry.cache_control();
+  etag_ = entry.etag();
+  status_code_ = net::HTTP_OK;
   net::URLRequestSimpleJob::Start();
+  return true;
 }
 
 void URLRequestBufferJob::GetResponseInfo(net::HttpResponseInfo* info) {
@@ -83,6 +100,11 @@ void URLRequestBufferJob::GetResponseInfo(net::HttpResponseInfo* info) {
     headers->AddHeader(content_type_header);
   }
 
+  if (!cache_control_.empty())
+    headers->AddHeader("Cache-Control: " + cache_control_);
+  if (!etag_.empty())
+    headers->AddHeader("ETag: " + etag_);
+
   info->headers = headers;
 }
 
@@ -18,8 +18,11 @@ class URLRequestBufferJob : public JsAsker<net::URLRequestSimpleJob> {
  public:
   URLRequestBufferJob(net::URLRequest*, net::NetworkDelegate*);
 
+  static const bool kSupportsResponseCache = true;
+
   // JsAsker:
   void StartAsync(std::unique_ptr<base::Value> options) override;
+  bool StartFromCache(const ProtocolResponseCache::Entry& entry) override;
 
   // URLRequestJob:
   void GetResponseInfo(net::HttpResponseInfo* info) override;
@@ -33,7 +36,9 @@ class URLRequestBufferJob : public JsAsker<net::URLRequestSimpleJob> {
  private:
   std::string mime_type_;
   std::string charset_;
-  scoped_refptr<base::RefCountedBytes> data_;
+  scoped_refptr<base::RefCountedMemory> data_;
+  std::string cache_control_;
+  std::string etag_;
   net::HttpStatusCode status_code_;
 
   DISALLOW_COPY_AND_ASSIGN(URLRequestBufferJob);
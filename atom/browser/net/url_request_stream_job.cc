@@ -0,0 +1,393 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/url_request_stream_job.h"
+
+#include <algorithm>
+#include <map>
+#include <string>
+
+#include "atom/common/api/event_emitter_caller.h"
+#include "atom/common/atom_constants.h"
+#include "atom/common/native_mate_converters/callback.h"
+#include "atom/common/native_mate_converters/value_converter.h"
+#include "base/strings/string_number_conversions.h"
+#include "native_mate/dictionary.h"
+#include "net/base/net_errors.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_status_code.h"
+#include "net/http/http_util.h"
+
+#include "atom/common/node_includes.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+// The stream is paused when more than |kHighWaterMark| bytes are waiting to
+// be read, and resumed once they are down to |kLowWaterMark|.
+const size_t kHighWaterMark = 1024 * 1024;
+const size_t kLowWaterMark = 256 * 1024;
+
+bool IsReadableStream(const mate::Dictionary& dict) {
+  v8::Local<v8::Function> function;
+  return dict.Get("on", &function) && dict.Get("pause", &function) &&
+         dict.Get("resume", &function);
+}
+
+// Whether the |headers| from JavaScript can be added to the response without
+// breaking it.
+bool HasValidHeaders(const base::DictionaryValue& headers) {
+  for (base::DictionaryValue::Iterator it(headers); !it.IsAtEnd();
+       it.Advance()) {
+    if (!net::HttpUtil::IsValidHeaderName(it.key()))
+      return false;
+    std::string value;
+    const base::ListValue* values;
+    if (it.value().GetAsString(&value)) {
+      if (!net::HttpUtil::IsValidHeaderValue(value))
+        return false;
+    } else if (it.value().GetAsList(&values)) {
+      for (size_t i = 0; i < values->GetSize(); ++i) {
+        if (values->GetString(i, &value) &&
+            !net::HttpUtil::IsValidHeaderValue(value))
+          return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+// Listens to the events of a stream on the UI thread and forwards them to
+// the job on the IO thread.
+class StreamSubscriber {
+ public:
+  StreamSubscriber(v8::Isolate* isolate, v8::Local<v8::Object> stream)
+      : isolate_(isolate),
+        stream_(isolate, stream),
+        finished_(false),
+        weak_factory_(this) {}
+
+  ~StreamSubscriber() {
+    DCHECK_CURRENTLY_ON(BrowserThread::UI);
+    v8::Locker locker(isolate_);
+    v8::HandleScope handle_scope(isolate_);
+    auto stream = v8::Local<v8::Object>::New(isolate_, stream_);
+    for (const auto& listener : listeners_) {
+      mate::CustomEmit(isolate_, stream, "removeListener", listener.first,
+                       v8::Local<v8::Value>::New(isolate_, listener.second));
+    }
+
+    // The request is gone, so stop a stream that would otherwise keep
+    // generating data nobody reads, or stay paused forever.
+    if (!finished_) {
+      v8::Local<v8::Function> destroy;
+      if (mate::Dictionary(isolate_, stream).Get("destroy", &destroy))
+        mate::CustomEmit(isolate_, stream, "destroy");
+      else
+        mate::CustomEmit(isolate_, stream, "pause");
+    }
+  }
+
+  void Start(base::WeakPtr<URLRequestStreamJob> job) {
+    DCHECK_CURRENTLY_ON(BrowserThread::UI);
+    job_ = job;
+
+    v8::Locker locker(isolate_);
+    v8::HandleScope handle_scope(isolate_);
+    // Adding a data listener switches the stream to flowing mode.
+    On("data", base::Bind(&StreamSubscriber::OnData,
+                          weak_factory_.GetWeakPtr()));
+    On("end", base::Bind(&StreamSubscriber::OnEnd,
+                         weak_factory_.GetWeakPtr()));
+    On("error", base::Bind(&StreamSubscriber::OnError,
+                           weak_factory_.GetWeakPtr()));
+  }
+
+  void SetPaused(bool paused) {
+    DCHECK_CURRENTLY_ON(BrowserThread::UI);
+    v8::Locker locker(isolate_);
+    v8::HandleScope handle_scope(isolate_);
+    mate::CustomEmit(isolate_, v8::Local<v8::Object>::New(isolate_, stream_),
+                     paused ? "pause" : "resume");
+  }
+
+ private:
+  using EventCallback = base::Callback<void(mate::Arguments*)>;
+
+  void On(const std::string& event, const EventCallback& callback) {
+    v8::Local<v8::Value> listener = mate::ConvertToV8(isolate_, callback);
+    listeners_[event].Reset(isolate_, listener);
+    mate::CustomEmit(isolate_, v8::Local<v8::Object>::New(isolate_, stream_),
+                     "on", event, listener);
+  }
+
+  void OnData(mate::Arguments* args) {
+    v8::Local<v8::Value> chunk;
+    if (!args->GetNext(&chunk))
+      return;
+
+    // The chunk belongs to V8, so it has to be copied for the IO thread.
+    const char* data = nullptr;
+    size_t length = 0;
+    std::string string;
+    if (node::Buffer::HasInstance(chunk)) {
+      data = node::Buffer::Data(chunk);
+      length = node::Buffer::Length(chunk);
+    } else if (mate::ConvertFromV8(isolate_, chunk, &string)) {
+      data = string.data();
+      length = string.size();
+    }
+    if (length == 0)
+      return;
+
+    scoped_refptr<net::IOBufferWithSize> buffer(
+        new net::IOBufferWithSize(static_cast<int>(length)));
+    memcpy(buffer->data(), data, length);
+    BrowserThread::PostTask(
+        BrowserThread::IO, FROM_HERE,
+        base::Bind(&URLRequestStreamJob::OnData, job_, buffer));
+  }
+
+  void OnEnd(mate::Arguments* args) {
+    finished_ = true;
+    BrowserThread::PostTask(
+        BrowserThread::IO, FROM_HERE,
+        base::Bind(&URLRequestStreamJob::OnEnd, job_));
+  }
+
+  void OnError(mate::Arguments* args) {
+    finished_ = true;
+    BrowserThread::PostTask(
+        BrowserThread::IO, FROM_HERE,
+        base::Bind(&URLRequestStreamJob::OnError, job_, net::ERR_FAILED));
+  }
+
+  v8::Isolate* isolate_;
+  v8::Global<v8::Object> stream_;
+  std::map<std::string, v8::Global<v8::Value>> listeners_;
+  base::WeakPtr<URLRequestStreamJob> job_;
+  // Whether the stream ended or failed.
+  bool finished_;
+
+  base::WeakPtrFactory<StreamSubscriber> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(StreamSubscriber);
+};
+
+URLRequestStreamJob::URLRequestStreamJob(
+    net::URLRequest* request, net::NetworkDelegate* network_delegate)
+    : JsAsker<net::URLRequestJob>(request, network_delegate),
+      start_error_(net::ERR_NOT_IMPLEMENTED),
+      status_code_(net::HTTP_OK),
+      chunk_offset_(0),
+      buffered_bytes_(0),
+      paused_(false),
+      ended_(false),
+      stream_error_(net::OK),
+      pending_buffer_size_(0),
+      weak_factory_(this) {
+}
+
+URLRequestStreamJob::~URLRequestStreamJob() {
+  if (subscriber_)
+    BrowserThread::DeleteSoon(BrowserThread::UI, FROM_HERE,
+                              subscriber_.release());
+}
+
+void URLRequestStreamJob::OnData(scoped_refptr<net::IOBufferWithSize> chunk) {
+  buffered_bytes_ += chunk->size();
+  chunks_.push_back(chunk);
+
+  if (!pending_buffer_) {
+    if (!paused_ && buffered_bytes_ > kHighWaterMark)
+      SetStreamPaused(true);
+    return;
+  }
+
+  int bytes_read = ReadChunks(pending_buffer_.get(), pending_buffer_size_);
+  pending_buffer_ = nullptr;
+  pending_buffer_size_ = 0;
+  if (!paused_ && buffered_bytes_ > kHighWaterMark)
+    SetStreamPaused(true);
+  // The request may delete the job when the read completes.
+  ReadRawDataComplete(bytes_read);
+}
+
+void URLRequestStreamJob::OnEnd() {
+  ended_ = true;
+  if (pending_buffer_) {
+    pending_buffer_ = nullptr;
+    pending_buffer_size_ = 0;
+    ReadRawDataComplete(0);
+  }
+}
+
+void URLRequestStreamJob::OnError(int error) {
+  stream_error_ = error;
+  if (pending_buffer_) {
+    pending_buffer_ = nullptr;
+    pending_buffer_size_ = 0;
+    ReadRawDataComplete(error);
+  }
+}
+
+bool URLRequestStreamJob::ShouldConvertOptions() const {
+  // Converting a stream would copy its whole object graph.
+  return false;
+}
+
+void URLRequestStreamJob::BeforeStartInUI(
+    v8::Isolate* isolate, v8::Local<v8::Value> value) {
+  int error;
+  if (mate::ConvertFromV8(isolate, value, &error)) {
+    start_error_ = error;
+    return;
+  }
+
+  mate::Dictionary options;
+  if (!mate::ConvertFromV8(isolate, value, &options))
+    return;
+  if (options.Get("error", &error)) {
+    start_error_ = error;
+    return;
+  }
+
+  // Either the stream, or an object with the stream as |data|.
+  mate::Dictionary stream = options;
+  if (!IsReadableStream(options)) {
+    if (!options.Get("data", &stream) || !IsReadableStream(stream))
+      return;
+
+    if (options.Get("statusCode", &status_code_) &&
+        (status_code_ < 100 || status_code_ > 599)) {
+      start_error_ = net::ERR_INVALID_ARGUMENT;
+      return;
+    }
+    headers_.reset(new base::DictionaryValue);
+    if (!options.Get("headers", headers_.get())) {
+      headers_.reset();
+    } else if (!HasValidHeaders(*headers_)) {
+      start_error_ = net::ERR_INVALID_ARGUMENT;
+      return;
+    }
+  }
+
+  subscriber_.reset(new StreamSubscriber(isolate, stream.GetHandle()));
+  start_error_ = net::OK;
+}
+
+void URLRequestStreamJob::StartAsync(std::unique_ptr<base::Value> options) {
+  if (start_error_ != net::OK) {
+    NotifyStartError(net::URLRequestStatus(
+          net::URLRequestStatus::FAILED, start_error_));
+    return;
+  }
+
+  std::string status("HTTP/1.1 ");
+  status.append(base::IntToString(status_code_));
+  status.append(" ");
+  status.append(net::GetHttpReasonPhrase(
+      static_cast<net::HttpStatusCode>(status_code_)));
+  status.append("\0\0", 2);
+  response_headers_ = new net::HttpResponseHeaders(status);
+
+  if (headers_) {
+    for (base::DictionaryValue::Iterator it(*headers_); !it.IsAtEnd();
+         it.Advance()) {
+      std::string value;
+      const base::ListValue* values;
+      if (it.value().GetAsString(&value)) {
+        response_headers_->AddHeader(it.key() + ": " + value);
+      } else if (it.value().GetAsList(&values)) {
+        for (size_t i = 0; i < values->GetSize(); ++i) {
+          if (values->GetString(i, &value))
+            response_headers_->AddHeader(it.key() + ": " + value);
+        }
+      }
+    }
+  }
+  if (!response_headers_->HasHeader("Access-Control-Allow-Origin"))
+    response_headers_->AddHeader(kCORSHeader);
+
+  BrowserThread::PostTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(&StreamSubscriber::Start,
+                 base::Unretained(subscriber_.get()),
+                 weak_factory_.GetWeakPtr()));
+  NotifyHeadersComplete();
+}
+
+void URLRequestStreamJob::Kill() {
+  // Drop the events still on their way from the stream.
+  weak_factory_.InvalidateWeakPtrs();
+  pending_buffer_ = nullptr;
+  JsAsker<URLRequestJob>::Kill();
+}
+
+int URLRequestStreamJob::ReadRawData(net::IOBuffer* dest, int dest_size) {
+  if (!chunks_.empty())
+    return ReadChunks(dest, dest_size);
+  if (stream_error_ != net::OK)
+    return stream_error_;
+  if (ended_)
+    return 0;
+
+  // Wait for the next chunk of the stream.
+  pending_buffer_ = dest;
+  pending_buffer_size_ = dest_size;
+  return net::ERR_IO_PENDING;
+}
+
+bool URLRequestStreamJob::GetMimeType(std::string* mime_type) const {
+  if (!response_headers_)
+    return false;
+  return response_headers_->GetMimeType(mime_type);
+}
+
+void URLRequestStreamJob::GetResponseInfo(net::HttpResponseInfo* info) {
+  if (response_headers_)
+    info->headers = response_headers_;
+}
+
+int URLRequestStreamJob::GetResponseCode() const {
+  if (!response_headers_)
+    return -1;
+  return response_headers_->response_code();
+}
+
+int URLRequestStreamJob::ReadChunks(net::IOBuffer* dest, int dest_size) {
+  int bytes_read = 0;
+  while (bytes_read < dest_size && !chunks_.empty()) {
+    net::IOBufferWithSize* chunk = chunks_.front().get();
+    int bytes = std::min(dest_size - bytes_read,
+                         chunk->size() - chunk_offset_);
+    memcpy(dest->data() + bytes_read, chunk->data() + chunk_offset_, bytes);
+    bytes_read += bytes;
+    chunk_offset_ += bytes;
+    if (chunk_offset_ == chunk->size()) {
+      chunks_.pop_front();
+      chunk_offset_ = 0;
+    }
+  }
+
+  buffered_bytes_ -= bytes_read;
+  if (paused_ && buffered_bytes_ <= kLowWaterMark)
+    SetStreamPaused(false);
+  return bytes_read;
+}
+
+void URLRequestStreamJob::SetStreamPaused(bool paused) {
+  paused_ = paused;
+  BrowserThread::PostTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(&StreamSubscriber::SetPaused,
+                 base::Unretained(subscriber_.get()), paused));
+}
+
+}  // namespace atom
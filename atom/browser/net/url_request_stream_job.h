@@ -0,0 +1,80 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_URL_REQUEST_STREAM_JOB_H_
+#define ATOM_BROWSER_NET_URL_REQUEST_STREAM_JOB_H_
+
+#include <deque>
+#include <memory>
+#include <string>
+
+#include "atom/browser/net/js_asker.h"
+#include "base/memory/weak_ptr.h"
+#include "net/base/io_buffer.h"
+#include "net/url_request/url_request_job.h"
+
+namespace atom {
+
+class StreamSubscriber;
+
+// Serves the response from a Node readable stream. The chunks emitted by the
+// stream are posted to the IO thread as they arrive and handed to pending
+// reads, the stream is paused while too much data is waiting to be read.
+class URLRequestStreamJob : public JsAsker<net::URLRequestJob> {
+ public:
+  URLRequestStreamJob(net::URLRequest*, net::NetworkDelegate*);
+  ~URLRequestStreamJob() override;
+
+  // Called by the StreamSubscriber with the events of the stream.
+  void OnData(scoped_refptr<net::IOBufferWithSize> chunk);
+  void OnEnd();
+  void OnError(int error);
+
+ protected:
+  // JsAsker:
+  bool ShouldConvertOptions() const override;
+  void BeforeStartInUI(v8::Isolate*, v8::Local<v8::Value>) override;
+  void StartAsync(std::unique_ptr<base::Value> options) override;
+
+  // net::URLRequestJob:
+  void Kill() override;
+  int ReadRawData(net::IOBuffer* buf, int buf_size) override;
+  bool GetMimeType(std::string* mime_type) const override;
+  void GetResponseInfo(net::HttpResponseInfo* info) override;
+  int GetResponseCode() const override;
+
+ private:
+  // Moves the buffered chunks into |buf|, returns the bytes copied.
+  int ReadChunks(net::IOBuffer* buf, int buf_size);
+  void SetStreamPaused(bool paused);
+
+  // Read from the handler's value in BeforeStartInUI.
+  int start_error_;
+  int status_code_;
+  std::unique_ptr<base::DictionaryValue> headers_;
+  // Only used and deleted on the UI thread.
+  std::unique_ptr<StreamSubscriber> subscriber_;
+
+  scoped_refptr<net::HttpResponseHeaders> response_headers_;
+
+  // Chunks that have not been read yet, the front one from |chunk_offset_|.
+  std::deque<scoped_refptr<net::IOBufferWithSize>> chunks_;
+  int chunk_offset_;
+  size_t buffered_bytes_;
+  bool paused_;
+  bool ended_;
+  int stream_error_;
+
+  // Saved arguments passed to ReadRawData while waiting for data.
+  scoped_refptr<net::IOBuffer> pending_buffer_;
+  int pending_buffer_size_;
+
+  base::WeakPtrFactory<URLRequestStreamJob> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(URLRequestStreamJob);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_URL_REQUEST_STREAM_JOB_H_
@@ -17,18 +17,36 @@ URLRequestStringJob::URLRequestStringJob(
 }
 
 void URLRequestStringJob::StartAsync(std::unique_ptr<base::Value> options) {
+  std::string data;
   if (options->IsType(base::Value::Type::DICTIONARY)) {
     base::DictionaryValue* dict =
         static_cast<base::DictionaryValue*>(options.get());
     dict->GetString("mimeType", &mime_type_);
     dict->GetString("charset", &charset_);
-    dict->GetString("data", &data_);
+    dict->GetString("data", &data);
+    ProtocolResponseCache::GetCachingHeaders(*dict, &cache_control_, &etag_);
   } else if (options->IsType(base::Value::Type::STRING)) {
-    options->GetAsString(&data_);
+    options->GetAsString(&data);
+  }
+  data_ = base::RefCountedString::TakeString(&data);
+  if (response_cache()) {
+    response_cache()->Put(request(), new ProtocolResponseCache::Entry(
+        mime_type_, charset_, data_, cache_control_, etag_));
   }
   net::URLRequestSimpleJob::Start();
 }
 
+bool URLRequestStringJob::StartFromCache(
+    const ProtocolResponseCache::Entry& entry) {
+  mime_type_ = entry.mime_type();
+  charset_ = entry.charset();
+  data_ = entry.data();
+  cache_control_ = entry.cache_control();
+  etag_ = entry.etag();
+  net::URLRequestSimpleJob::Start();
+  return true;
+}
+
 void URLRequestStringJob::GetResponseInfo(net::HttpResponseInfo* info) {
   std::string status("HTTP/1.1 200 OK");
   auto* headers = new net::HttpResponseHeaders(status);
@@ -42,13 +60,18 @@ void URLRequestStringJob::GetResponseInfo(net::HttpResponseInfo* info) {
     headers->AddHeader(content_type_header);
   }
 
+  if (!cache_control_.empty())
+    headers->AddHeader("Cache-Control: " + cache_control_);
+  if (!etag_.empty())
+    headers->AddHeader("ETag: " + etag_);
+
   info->headers = headers;
 }
 
-int URLRequestStringJob::GetData(
+int URLRequestStringJob::GetRefCountedData(
     std::string* mime_type,
     std::string* charset,
-    std::string* data,
+    scoped_refptr<base::RefCountedMemory>* data,
     const net::CompletionCallback& callback) const {
   *mime_type = mime_type_;
   *charset = charset_;
@@ -8,6 +8,7 @@
 #include <string>
 
 #include "atom/browser/net/js_asker.h"
+#include "base/memory/ref_counted_memory.h"
 #include "net/url_request/url_request_simple_job.h"
 
 namespace atom {
@@ -16,22 +17,28 @@ class URLRequestStringJob : public JsAsker<net::URLRequestSimpleJob> {
  public:
   URLRequestStringJob(net::URLRequest*, net::NetworkDelegate*);
 
+  static const bool kSupportsResponseCache = true;
+
   // JsAsker:
   void StartAsync(std::unique_ptr<base::Value> options) override;
+  bool StartFromCache(const ProtocolResponseCache::Entry& entry) override;
 
   // URLRequestJob:
   void GetResponseInfo(net::HttpResponseInfo* info) override;
 
   // URLRequestSimpleJob:
-  int GetData(std::string* mime_type,
-              std::string* charset,
-              std::string* data,
-              const net::CompletionCallback& callback) const override;
+  int GetRefCountedData(std::string* mime_type,
+                        std::string* charset,
+                        scoped_refptr<base::RefCountedMemory>* data,
+                        const net::CompletionCallback& callback) const override;
 
  private:
   std::string mime_type_;
   std::string charset_;
-  std::string data_;
+  // Kept as ref-counted memory so it can be shared with the response cache.
+  scoped_refptr<base::RefCountedMemory> data_;
+  std::string cache_control_;
+  std::string etag_;
 
   DISALLOW_COPY_AND_ASSIGN(URLRequestStringJob);
 };
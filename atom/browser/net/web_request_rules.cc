@@ -0,0 +1,172 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/web_request_rules.h"
+
+#include <utility>
+
+#include "atom/browser/net/atom_network_delegate.h"
+#include "base/stl_util.h"
+#include "content/public/browser/resource_request_info.h"
+#include "net/base/net_errors.h"
+#include "net/http/http_request_headers.h"
+#include "net/http/http_response_headers.h"
+#include "net/url_request/url_request.h"
+#include "url/url_constants.h"
+
+namespace atom {
+
+namespace {
+
+// Returns the secure version of |url|, or an empty GURL when it has none.
+GURL UpgradeScheme(const GURL& url) {
+  const char* scheme = nullptr;
+  if (url.SchemeIs(url::kHttpScheme))
+    scheme = url::kHttpsScheme;
+  else if (url.SchemeIs(url::kWsScheme))
+    scheme = url::kWssScheme;
+  else
+    return GURL();
+
+  GURL::Replacements replacements;
+  replacements.SetSchemeStr(scheme);
+  return url.ReplaceComponents(replacements);
+}
+
+}  // namespace
+
+WebRequestRules::Rule::Rule() : action(Action::BLOCK) {
+}
+
+WebRequestRules::Rule::Rule(const Rule& other) = default;
+
+WebRequestRules::Rule::~Rule() {
+}
+
+WebRequestRules::WebRequestRules(const std::vector<Rule>& rules) {
+  for (const Rule& rule : rules) {
+    switch (rule.action) {
+      case Action::BLOCK:
+      case Action::REDIRECT:
+      case Action::UPGRADE_SCHEME:
+        request_rules_.Add(rule);
+        break;
+      case Action::SET_REQUEST_HEADER:
+      case Action::REMOVE_REQUEST_HEADER:
+        send_headers_rules_.Add(rule);
+        break;
+      case Action::SET_RESPONSE_HEADER:
+      case Action::REMOVE_RESPONSE_HEADER:
+        headers_received_rules_.Add(rule);
+        break;
+    }
+  }
+  request_rules_.Build();
+  send_headers_rules_.Build();
+  headers_received_rules_.Build();
+}
+
+WebRequestRules::~WebRequestRules() {
+}
+
+bool WebRequestRules::OnBeforeRequest(net::URLRequest* request,
+                                      GURL* new_url,
+                                      int* result) const {
+  for (const Rule* rule : request_rules_.GetMatches(request)) {
+    if (rule->action == Action::BLOCK) {
+      *result = net::ERR_BLOCKED_BY_CLIENT;
+      return true;
+    }
+
+    // Skip the rules that would not change the URL, otherwise a redirect
+    // matching its own target would loop.
+    GURL url = rule->action == Action::REDIRECT ? rule->redirect_url
+                                                : UpgradeScheme(request->url());
+    if (url.is_empty() || url == request->url())
+      continue;
+    *new_url = url;
+    *result = net::OK;
+    return true;
+  }
+  return false;
+}
+
+bool WebRequestRules::OnBeforeSendHeaders(
+    net::URLRequest* request,
+    net::HttpRequestHeaders* headers) const {
+  std::vector<const Rule*> rules = send_headers_rules_.GetMatches(request);
+  for (const Rule* rule : rules) {
+    if (rule->action == Action::SET_REQUEST_HEADER)
+      headers->SetHeader(rule->header_name, rule->header_value);
+    else
+      headers->RemoveHeader(rule->header_name);
+  }
+  return !rules.empty();
+}
+
+bool WebRequestRules::OnHeadersReceived(
+    net::URLRequest* request,
+    const net::HttpResponseHeaders* original,
+    scoped_refptr<net::HttpResponseHeaders>* override) const {
+  if (!original)
+    return false;
+
+  std::vector<const Rule*> rules = headers_received_rules_.GetMatches(request);
+  for (const Rule* rule : rules) {
+    // Only copy the headers once something changes them.
+    if (!*override)
+      *override = new net::HttpResponseHeaders(original->raw_headers());
+    (*override)->RemoveHeader(rule->header_name);
+    if (rule->action == Action::SET_RESPONSE_HEADER)
+      (*override)->AddHeader(rule->header_name + ": " + rule->header_value);
+  }
+  return !rules.empty();
+}
+
+WebRequestRules::RuleList::RuleList() {
+}
+
+WebRequestRules::RuleList::~RuleList() {
+}
+
+void WebRequestRules::RuleList::Add(const Rule& rule) {
+  rules.push_back(rule);
+}
+
+void WebRequestRules::RuleList::Build() {
+  std::vector<std::pair<URLPattern, int>> patterns;
+  for (size_t i = 0; i < rules.size(); ++i) {
+    int index = static_cast<int>(i);
+    if (rules[i].url_patterns.empty())
+      any_url.insert(index);
+    for (const auto& pattern : rules[i].url_patterns)
+      patterns.push_back(std::make_pair(pattern, index));
+  }
+  url_patterns = URLPatternMatcher(patterns);
+}
+
+std::vector<const WebRequestRules::Rule*>
+WebRequestRules::RuleList::GetMatches(net::URLRequest* request) const {
+  std::vector<const Rule*> result;
+  if (rules.empty())
+    return result;
+
+  std::set<int> indices(any_url);
+  url_patterns.GetMatches(request->url(), &indices);
+  if (indices.empty())
+    return result;
+
+  auto info = content::ResourceRequestInfo::ForRequest(request);
+  const char* type =
+      info ? ResourceTypeToString(info->GetResourceType()) : "other";
+  for (int index : indices) {
+    const Rule& rule = rules[index];
+    if (rule.resource_types.empty() ||
+        base::ContainsKey(rule.resource_types, type))
+      result.push_back(&rule);
+  }
+  return result;
+}
+
+}  // namespace atom
@@ -0,0 +1,112 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_WEB_REQUEST_RULES_H_
+#define ATOM_BROWSER_NET_WEB_REQUEST_RULES_H_
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "atom/browser/net/url_pattern_matcher.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "extensions/common/url_pattern.h"
+#include "url/gurl.h"
+
+namespace net {
+class HttpRequestHeaders;
+class HttpResponseHeaders;
+class URLRequest;
+}
+
+namespace atom {
+
+// Declarative webRequest rules, evaluated by the network delegate on the IO
+// thread without asking JavaScript.
+//
+// Rules are compiled once into one list per event, so each event only looks
+// at the rules that can act on it, and the URL patterns of each list are
+// indexed so a request only tests the rules that can match its URL. The
+// object is immutable after creation.
+class WebRequestRules {
+ public:
+  enum class Action {
+    BLOCK,
+    REDIRECT,
+    UPGRADE_SCHEME,
+    SET_REQUEST_HEADER,
+    REMOVE_REQUEST_HEADER,
+    SET_RESPONSE_HEADER,
+    REMOVE_RESPONSE_HEADER,
+  };
+
+  struct Rule {
+    Rule();
+    Rule(const Rule& other);
+    ~Rule();
+
+    Action action;
+    // Empty sets match everything.
+    std::set<URLPattern> url_patterns;
+    std::set<std::string> resource_types;
+    // For REDIRECT.
+    GURL redirect_url;
+    // For the header actions, |header_value| is only used when setting.
+    std::string header_name;
+    std::string header_value;
+  };
+
+  explicit WebRequestRules(const std::vector<Rule>& rules);
+  ~WebRequestRules();
+
+  // The first matching block, redirect or upgrade rule decides the request.
+  // Returns false when no rule matched, otherwise |result| is the net error
+  // to return and |new_url| may be set.
+  bool OnBeforeRequest(net::URLRequest* request,
+                       GURL* new_url,
+                       int* result) const;
+
+  // Apply all matching header rules in order, returns whether any matched.
+  bool OnBeforeSendHeaders(net::URLRequest* request,
+                           net::HttpRequestHeaders* headers) const;
+  bool OnHeadersReceived(
+      net::URLRequest* request,
+      const net::HttpResponseHeaders* original_response_headers,
+      scoped_refptr<net::HttpResponseHeaders>* override_response_headers)
+      const;
+
+  bool empty() const {
+    return request_rules_.rules.empty() && send_headers_rules_.rules.empty() &&
+           headers_received_rules_.rules.empty();
+  }
+
+ private:
+  struct RuleList {
+    RuleList();
+    ~RuleList();
+
+    void Add(const Rule& rule);
+    void Build();
+
+    // Returns the rules matching |request| in the order they were added.
+    std::vector<const Rule*> GetMatches(net::URLRequest* request) const;
+
+    std::vector<Rule> rules;
+    // The URL patterns of the rules, with the index of their rule as id.
+    URLPatternMatcher url_patterns;
+    // Rules without URL patterns.
+    std::set<int> any_url;
+  };
+
+  RuleList request_rules_;
+  RuleList send_headers_rules_;
+  RuleList headers_received_rules_;
+
+  DISALLOW_COPY_AND_ASSIGN(WebRequestRules);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_WEB_REQUEST_RULES_H_
@@ -4,12 +4,14 @@
 
 #include "atom/browser/osr/osr_render_widget_host_view.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "base/callback_helpers.h"
 #include "base/location.h"
 #include "base/memory/ptr_util.h"
 #include "base/single_thread_task_runner.h"
+#include "base/threading/sequenced_worker_pool.h"
 #include "base/time/time.h"
 #include "cc/output/copy_output_request.h"
 #include "cc/scheduler/delay_based_time_source.h"
@@ -22,6 +24,8 @@
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/context_factory.h"
 #include "media/base/video_frame.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkPaint.h"
 #include "ui/compositor/compositor.h"
 #include "ui/compositor/layer.h"
 #include "ui/compositor/layer_type.h"
@@ -37,6 +41,25 @@ namespace {
 const float kDefaultScaleFactor = 1.0;
 const int kFrameRetryLimit = 2;
 
+// Copy requests plus captured frames that are not painted yet.
+const int kMaxFramesInFlight = 2;
+// How far the frame rate is lowered when the paint handler is slow.
+const int kMaxFrameDurationScale = 4;
+
+// Draws |popup| over |bitmap| at |pos|, runs on the popup compositing
+// sequence. Skia's blitters use the SIMD paths of the CPU they run on.
+void ComposePopupFrame(std::shared_ptr<SkBitmap> bitmap,
+                       const SkBitmap& popup,
+                       const gfx::Rect& pos) {
+  if (popup.drawsNothing())
+    return;
+
+  SkCanvas canvas(*bitmap);
+  SkPaint paint;
+  paint.setBlendMode(SkBlendMode::kSrc);
+  canvas.drawBitmap(popup, pos.x(), pos.y(), &paint);
+}
+
 #if !defined(OS_MACOSX)
 
 const int kResizeLockTimeoutMs = 67;
@@ -108,6 +131,9 @@ class AtomCopyFrameGenerator {
       next_frame_time_(base::TimeTicks::Now()),
       frame_duration_(base::TimeDelta::FromMicroseconds(
         frame_rate_threshold_us)),
+      adaptive_frame_duration_(frame_duration_),
+      frames_in_flight_(0),
+      paint_rejected_(false),
       weak_ptr_factory_(this) {
     last_time_ = base::Time::Now();
   }
@@ -116,6 +142,18 @@ class AtomCopyFrameGenerator {
     if (!view_->render_widget_host())
       return;
 
+    {
+      base::AutoLock autolock(lock_);
+      // Fold the damage into the next capture instead of piling up bitmaps
+      // when the paint handler does not keep up.
+      if (frames_in_flight_ >= kMaxFramesInFlight) {
+        pending_damage_rect_.Union(damage_rect);
+        ++stats_.coalesced_frames;
+        return;
+      }
+      ++frames_in_flight_;
+    }
+
     std::unique_ptr<cc::CopyOutputRequest> request =
         cc::CopyOutputRequest::CreateBitmapRequest(base::Bind(
             &AtomCopyFrameGenerator::CopyFromCompositingSurfaceHasResult,
@@ -127,8 +165,27 @@ class AtomCopyFrameGenerator {
   }
 
   void set_frame_rate_threshold_us(int frame_rate_threshold_us) {
+    base::AutoLock autolock(lock_);
     frame_duration_ = base::TimeDelta::FromMicroseconds(
       frame_rate_threshold_us);
+    adaptive_frame_duration_ = frame_duration_;
+  }
+
+  void OnPaintRejected() {
+    base::AutoLock autolock(lock_);
+    ++stats_.dropped_frames;
+    paint_rejected_ = true;
+  }
+
+  OffScreenFrameStats stats() const {
+    base::AutoLock autolock(lock_);
+    OffScreenFrameStats stats = stats_;
+    if (adaptive_frame_duration_ > base::TimeDelta()) {
+      stats.frame_rate = static_cast<int>(
+          base::Time::kMicrosecondsPerSecond /
+          adaptive_frame_duration_.InMicroseconds());
+    }
+    return stats;
   }
 
  private:
@@ -137,6 +194,7 @@ class AtomCopyFrameGenerator {
       std::unique_ptr<cc::CopyOutputResult> result) {
     if (result->IsEmpty() || result->size().IsEmpty() ||
         !view_->render_widget_host()) {
+      OnFrameFinished();
       OnCopyFrameCaptureFailure(damage_rect);
       return;
     }
@@ -144,34 +202,76 @@ class AtomCopyFrameGenerator {
     DCHECK(result->HasBitmap());
     std::unique_ptr<SkBitmap> source = result->TakeBitmap();
     DCHECK(source);
-    if (source) {
+    if (!source) {
+      OnFrameFinished();
+      OnCopyFrameCaptureFailure(damage_rect);
+      return;
+    }
+
+    std::shared_ptr<SkBitmap> bitmap(source.release());
+    base::TimeTicks now = base::TimeTicks::Now();
+    bool replaced_queued_frame = false;
+    {
+      base::AutoLock autolock(lock_);
+      frame_retry_count_ = 0;
+
+      // A frame is still waiting for its turn, replace it with the newer one
+      // so at most one bitmap sits in the task queue.
+      if (queued_bitmap_) {
+        queued_damage_rect_.Union(damage_rect);
+        queued_bitmap_ = bitmap;
+        ++stats_.dropped_frames;
+        replaced_queued_frame = true;
+      }
+    }
+    if (replaced_queued_frame) {
+      OnFrameFinished();
+      return;
+    }
+
+    {
       base::AutoLock autolock(lock_);
-      std::shared_ptr<SkBitmap> bitmap(source.release());
 
-      base::TimeTicks now = base::TimeTicks::Now();
       base::TimeDelta next_frame_in = next_frame_time_ - now;
-      if (next_frame_in > frame_duration_ / 4) {
-        next_frame_time_ += frame_duration_;
+      if (next_frame_in > adaptive_frame_duration_ / 4) {
+        next_frame_time_ += adaptive_frame_duration_;
+        queued_bitmap_ = bitmap;
+        queued_damage_rect_ = damage_rect;
+        queued_time_ = now + next_frame_in;
         content::BrowserThread::PostDelayedTask(content::BrowserThread::UI,
           FROM_HERE,
-          base::Bind(&AtomCopyFrameGenerator::OnCopyFrameCaptureSuccess,
-            weak_ptr_factory_.GetWeakPtr(),
-            damage_rect,
-            bitmap),
+          base::Bind(&AtomCopyFrameGenerator::OnQueuedFrameReady,
+            weak_ptr_factory_.GetWeakPtr()),
           next_frame_in);
-      } else {
-        next_frame_time_ = now + frame_duration_;
-        OnCopyFrameCaptureSuccess(damage_rect, bitmap);
+        return;
       }
+      next_frame_time_ = now + adaptive_frame_duration_;
+    }
 
-      frame_retry_count_ = 0;
-    } else {
-      OnCopyFrameCaptureFailure(damage_rect);
+    // Paint outside of |lock_|, the handler may invalidate synchronously.
+    OnCopyFrameCaptureSuccess(damage_rect, now, bitmap);
+  }
+
+  void OnQueuedFrameReady() {
+    std::shared_ptr<SkBitmap> bitmap;
+    gfx::Rect damage_rect;
+    base::TimeTicks queued_time;
+    {
+      base::AutoLock autolock(lock_);
+      bitmap.swap(queued_bitmap_);
+      damage_rect = queued_damage_rect_;
+      queued_time = queued_time_;
     }
+    if (bitmap)
+      OnCopyFrameCaptureSuccess(damage_rect, queued_time, bitmap);
   }
 
   void OnCopyFrameCaptureFailure(const gfx::Rect& damage_rect) {
-    const bool force_frame = (++frame_retry_count_ <= kFrameRetryLimit);
+    bool force_frame;
+    {
+      base::AutoLock autolock(lock_);
+      force_frame = (++frame_retry_count_ <= kFrameRetryLimit);
+    }
     if (force_frame) {
       // Retry with the same |damage_rect|.
       content::BrowserThread::PostTask(content::BrowserThread::UI, FROM_HERE,
@@ -183,12 +283,72 @@ class AtomCopyFrameGenerator {
 
   void OnCopyFrameCaptureSuccess(
       const gfx::Rect& damage_rect,
+      base::TimeTicks queued_time,
       std::shared_ptr<SkBitmap> bitmap) {
+    base::TimeTicks start = base::TimeTicks::Now();
     base::AutoLock lock(onPaintLock_);
-    view_->OnPaint(damage_rect, *bitmap);
+    view_->OnCopiedFrame(
+        damage_rect, bitmap,
+        base::Bind(&AtomCopyFrameGenerator::OnFramePainted,
+                   weak_ptr_factory_.GetWeakPtr(), queued_time, start));
+  }
+
+  // Called once the paint handler got the frame, which happens later when
+  // popups are composited into it first.
+  void OnFramePainted(base::TimeTicks queued_time, base::TimeTicks start) {
+    OnFrameFinished();
+
+    // The time the frame waited behind other tasks plus the time spent on
+    // compositing and painting it is how fast frames are actually consumed.
+    base::TimeTicks end = base::TimeTicks::Now();
+    AdaptFrameDuration((start - queued_time) + (end - start));
+  }
+
+  // Frees the in-flight slot of a delivered or dropped frame, and captures
+  // the damage that was coalesced meanwhile.
+  void OnFrameFinished() {
+    gfx::Rect damage_rect;
+    {
+      base::AutoLock autolock(lock_);
+      DCHECK_GT(frames_in_flight_, 0);
+      --frames_in_flight_;
+      damage_rect = pending_damage_rect_;
+      pending_damage_rect_ = gfx::Rect();
+    }
+    if (!damage_rect.IsEmpty()) {
+      content::BrowserThread::PostTask(content::BrowserThread::UI, FROM_HERE,
+        base::Bind(&AtomCopyFrameGenerator::GenerateCopyFrame,
+          weak_ptr_factory_.GetWeakPtr(),
+          damage_rect));
+    }
+  }
+
+  void AdaptFrameDuration(base::TimeDelta consume_time) {
+    base::TimeDelta duration;
+    {
+      base::AutoLock autolock(lock_);
+      duration = adaptive_frame_duration_;
+      if (paint_rejected_ || consume_time > duration) {
+        // Back off quickly while the consumer falls behind.
+        duration = std::max(duration * 3 / 2, consume_time);
+      } else if (consume_time < duration / 2) {
+        // And recover slowly once it catches up.
+        duration = duration * 7 / 8;
+      }
+      paint_rejected_ = false;
+
+      duration = std::min(std::max(duration, frame_duration_),
+                          frame_duration_ * kMaxFrameDurationScale);
+      if (duration == adaptive_frame_duration_)
+        return;
+      adaptive_frame_duration_ = duration;
+    }
+    view_->SetAdaptiveFrameDuration(duration);
   }
 
-  base::Lock lock_;
+  // Guards all of the frame state below, which is shared by the copy
+  // results, the queued frame tasks and the paint handler.
+  mutable base::Lock lock_;
   base::Lock onPaintLock_;
   OffScreenRenderWidgetHostView* view_;
 
@@ -197,6 +357,19 @@ class AtomCopyFrameGenerator {
   int frame_retry_count_;
   base::TimeTicks next_frame_time_;
   base::TimeDelta frame_duration_;
+  base::TimeDelta adaptive_frame_duration_;
+
+  // Copy requests and frames waiting to be painted.
+  int frames_in_flight_;
+  gfx::Rect pending_damage_rect_;
+
+  // The frame waiting for |next_frame_time_|.
+  std::shared_ptr<SkBitmap> queued_bitmap_;
+  gfx::Rect queued_damage_rect_;
+  base::TimeTicks queued_time_;
+
+  bool paint_rejected_;
+  OffScreenFrameStats stats_;
 
   base::WeakPtrFactory<AtomCopyFrameGenerator> weak_ptr_factory_;
 
@@ -268,6 +441,7 @@ OffScreenRenderWidgetHostView::OffScreenRenderWidgetHostView(
       popup_position_(gfx::Rect()),
       hold_resize_(false),
       pending_resize_(false),
+      pending_popup_frames_(0),
       weak_ptr_factory_(this) {
   DCHECK(render_widget_host_);
   bool is_guest_view_hack = parent_host_view_ != nullptr;
@@ -942,10 +1116,76 @@ void OffScreenRenderWidgetHostView::OnPaint(
   ReleaseResize();
 }
 
+void OffScreenRenderWidgetHostView::OnCopiedFrame(
+    const gfx::Rect& damage_rect,
+    std::shared_ptr<SkBitmap> bitmap,
+    const base::Closure& painted) {
+  if (parent_callback_) {
+    // Nothing writes to a copied frame afterwards, so the parent can keep its
+    // pixels instead of copying them.
+    bitmap->setImmutable();
+    OnPaint(damage_rect, *bitmap);
+    painted.Run();
+    return;
+  }
+
+  // Keep frames in order while earlier ones are still being composited.
+  const bool has_popup = popup_host_view_ && popup_bitmap_.get();
+  if (!has_popup && pending_popup_frames_ == 0) {
+    OnPaint(damage_rect, *bitmap);
+    painted.Run();
+    return;
+  }
+
+  // The copied frame is not shared with anyone, so the popup is drawn right
+  // into it on the worker and the UI thread only gets the finished frame.
+  gfx::Rect damage(damage_rect);
+  gfx::Rect pos;
+  SkBitmap popup;
+  if (has_popup) {
+    pos = popup_host_view_->popup_position_;
+    damage.Union(pos);
+    popup = *popup_bitmap_;
+  }
+
+  if (!popup_task_runner_) {
+    base::SequencedWorkerPool* pool =
+        content::BrowserThread::GetBlockingPool();
+    popup_task_runner_ = pool->GetSequencedTaskRunnerWithShutdownBehavior(
+        pool->GetSequenceToken(),
+        base::SequencedWorkerPool::SKIP_ON_SHUTDOWN);
+  }
+
+  ++pending_popup_frames_;
+  popup_task_runner_->PostTaskAndReply(
+      FROM_HERE,
+      base::Bind(&ComposePopupFrame, bitmap, popup, pos),
+      base::Bind(&OffScreenRenderWidgetHostView::OnComposedFrame,
+                 weak_ptr_factory_.GetWeakPtr(), damage, bitmap, painted));
+}
+
+void OffScreenRenderWidgetHostView::OnComposedFrame(
+    const gfx::Rect& damage_rect,
+    std::shared_ptr<SkBitmap> bitmap,
+    const base::Closure& painted) {
+  --pending_popup_frames_;
+
+  HoldResize();
+  callback_.Run(damage_rect, *bitmap);
+  ReleaseResize();
+  painted.Run();
+}
+
 void OffScreenRenderWidgetHostView::OnPopupPaint(
     const gfx::Rect& damage_rect, const SkBitmap& bitmap) {
-  if (popup_host_view_ && popup_bitmap_.get())
-    bitmap.deepCopyTo(popup_bitmap_.get());
+  if (popup_host_view_ && popup_bitmap_.get()) {
+    // Frames being composited keep referencing the previous pixels, so they
+    // are replaced but never written to.
+    if (bitmap.isImmutable())
+      *popup_bitmap_ = bitmap;
+    else
+      bitmap.deepCopyTo(popup_bitmap_.get());
+  }
   InvalidateBounds(popup_host_view_->popup_position_);
 }
 
@@ -1073,6 +1313,28 @@ int OffScreenRenderWidgetHostView::GetFrameRate() const {
   return frame_rate_;
 }
 
+OffScreenFrameStats OffScreenRenderWidgetHostView::GetFrameStats() const {
+  if (copy_frame_generator_)
+    return copy_frame_generator_->stats();
+
+  OffScreenFrameStats stats;
+  stats.frame_rate = frame_rate_;
+  return stats;
+}
+
+void OffScreenRenderWidgetHostView::OnPaintRejected() {
+  if (copy_frame_generator_)
+    copy_frame_generator_->OnPaintRejected();
+}
+
+void OffScreenRenderWidgetHostView::SetAdaptiveFrameDuration(
+    base::TimeDelta frame_duration) {
+  if (begin_frame_timer_) {
+    begin_frame_timer_->SetFrameRateThresholdUs(
+        static_cast<int>(frame_duration.InMicroseconds()));
+  }
+}
+
 #if !defined(OS_MACOSX)
 ui::Compositor* OffScreenRenderWidgetHostView::GetCompositor() const {
   return compositor_.get();
@@ -5,6 +5,7 @@
 #ifndef ATOM_BROWSER_OSR_OSR_RENDER_WIDGET_HOST_VIEW_H_
 #define ATOM_BROWSER_OSR_OSR_RENDER_WIDGET_HOST_VIEW_H_
 
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -17,6 +18,7 @@
 #include "atom/browser/native_window_observer.h"
 #include "atom/browser/osr/osr_output_device.h"
 #include "base/process/kill.h"
+#include "base/sequenced_task_runner.h"
 #include "base/threading/thread.h"
 #include "base/time/time.h"
 #include "cc/output/compositor_frame.h"
@@ -58,6 +60,18 @@ namespace atom {
 class AtomCopyFrameGenerator;
 class AtomBeginFrameTimer;
 
+// Pacing counters of the frames copied from the compositor.
+struct OffScreenFrameStats {
+  // Frames that were captured but never painted, because a newer frame
+  // replaced them or the paint handler could not take them.
+  uint64_t dropped_frames = 0;
+  // Captures that were folded into a later one because too many frames were
+  // already in flight.
+  uint64_t coalesced_frames = 0;
+  // The frame rate after adapting to the paint handler.
+  int frame_rate = 0;
+};
+
 #if defined(OS_MACOSX)
 class MacHelper;
 #endif
@@ -215,6 +229,11 @@ class OffScreenRenderWidgetHostView
       content::RenderWidgetHostViewGuest* guest_host_view);
 
   void OnPaint(const gfx::Rect& damage_rect, const SkBitmap& bitmap);
+  // Called with frames copied from the compositor, which nothing else
+  // references. |painted| runs once the frame reached the paint callback.
+  void OnCopiedFrame(const gfx::Rect& damage_rect,
+                     std::shared_ptr<SkBitmap> bitmap,
+                     const base::Closure& painted);
   void OnPopupPaint(const gfx::Rect& damage_rect, const SkBitmap& bitmap);
 
   bool IsPopupWidget() const {
@@ -238,6 +257,13 @@ class OffScreenRenderWidgetHostView
   void SetFrameRate(int frame_rate);
   int GetFrameRate() const;
 
+  OffScreenFrameStats GetFrameStats() const;
+  // Called when the paint handler could not take the last frame, so the frame
+  // rate backs off until it catches up.
+  void OnPaintRejected();
+  // Changes the begin frame interval without changing the frame rate.
+  void SetAdaptiveFrameDuration(base::TimeDelta frame_duration);
+
   ui::Compositor* GetCompositor() const;
   ui::Layer* GetRootLayer() const;
   content::DelegatedFrameHost* GetDelegatedFrameHost() const;
@@ -263,6 +289,10 @@ class OffScreenRenderWidgetHostView
   void SetupFrameRate(bool force);
   void ResizeRootLayer();
 
+  void OnComposedFrame(const gfx::Rect& damage_rect,
+                       std::shared_ptr<SkBitmap> bitmap,
+                       const base::Closure& painted);
+
   cc::FrameSinkId AllocateFrameSinkId(bool is_guest_view_hack);
 
   // Weak ptrs.
@@ -298,6 +328,10 @@ class OffScreenRenderWidgetHostView
   bool hold_resize_;
   bool pending_resize_;
 
+  // Composites popups over copied frames off the UI thread.
+  scoped_refptr<base::SequencedTaskRunner> popup_task_runner_;
+  int pending_popup_frames_;
+
   std::unique_ptr<ui::Layer> root_layer_;
   std::unique_ptr<ui::Compositor> compositor_;
   std::unique_ptr<content::DelegatedFrameHost> delegated_frame_host_;
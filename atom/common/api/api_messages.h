@@ -5,6 +5,7 @@
 // Multiply-included file, no traditional include guard.
 
 #include "atom/common/draggable_region.h"
+#include "base/memory/shared_memory_handle.h"
 #include "base/strings/string16.h"
 #include "base/values.h"
 #include "content/public/common/common_param_traits.h"
@@ -25,6 +26,25 @@ IPC_MESSAGE_ROUTED2(AtomViewHostMsg_Message,
                     base::string16 /* channel */,
                     base::ListValue /* arguments */)
 
+// Same with AtomViewHostMsg_Message, but the arguments are serialized with
+// v8::ValueSerializer, see atom/common/api/value_serializer.h.
+IPC_MESSAGE_ROUTED2(AtomViewHostMsg_Message_Serialized,
+                    base::string16 /* channel */,
+                    std::vector<uint8_t> /* serialized arguments */)
+
+// Sends a large buffer in shared memory, only the handle is copied through the
+// channel.
+IPC_MESSAGE_ROUTED3(AtomViewHostMsg_Message_SharedMemory,
+                    base::string16 /* channel */,
+                    base::SharedMemoryHandle /* buffer */,
+                    uint32_t /* buffer size */)
+
+// Request of ipcRenderer.invoke, the reply is sent back to the frame with
+// |frame_routing_id| only.
+IPC_MESSAGE_ROUTED2(AtomViewHostMsg_Invoke,
+                    int /* frame_routing_id */,
+                    std::vector<uint8_t> /* serialized arguments */)
+
 IPC_SYNC_MESSAGE_ROUTED2_1(AtomViewHostMsg_Message_Sync,
                            base::string16 /* channel */,
                            base::ListValue /* arguments */,
@@ -35,6 +55,17 @@ IPC_MESSAGE_ROUTED3(AtomViewMsg_Message,
                     base::string16 /* channel */,
                     base::ListValue /* arguments */)
 
+// Same with AtomViewHostMsg_Message_SharedMemory, but sent to the main frame.
+IPC_MESSAGE_ROUTED3(AtomViewMsg_Message_SharedMemory,
+                    base::string16 /* channel */,
+                    base::SharedMemoryHandle /* buffer */,
+                    uint32_t /* buffer size */)
+
+// Reply to AtomViewHostMsg_Invoke, serialized like the request.
+IPC_MESSAGE_ROUTED2(AtomViewMsg_InvokeReply,
+                    int /* frame_routing_id */,
+                    std::vector<uint8_t> /* serialized reply */)
+
 IPC_MESSAGE_ROUTED0(AtomViewMsg_Offscreen)
 
 // Sent by the renderer when the draggable regions are updated.
@@ -4,9 +4,11 @@
 
 #include <stddef.h>
 
+#include <memory>
 #include <vector>
 
 #include "atom/common/asar/archive.h"
+#include "atom/common/asar/asar_util.h"
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "native_mate/arguments.h"
@@ -19,12 +21,18 @@
 
 namespace {
 
+// Keeps the archive, and thus its mapping, alive until the Buffer is freed.
+void FreeMappedBuffer(char* data, void* hint) {
+  delete static_cast<std::shared_ptr<asar::Archive>*>(hint);
+}
+
 class Archive : public mate::Wrappable<Archive> {
  public:
   static v8::Local<v8::Value> Create(v8::Isolate* isolate,
                                       const base::FilePath& path) {
-    std::unique_ptr<asar::Archive> archive(new asar::Archive(path));
-    if (!archive->Init())
+    std::shared_ptr<asar::Archive> archive =
+        asar::GetOrCreateAsarArchive(path);
+    if (!archive)
       return v8::False(isolate);
     return (new Archive(isolate, std::move(archive)))->GetWrapper();
   }
@@ -39,12 +47,13 @@ class Archive : public mate::Wrappable<Archive> {
         .SetMethod("readdir", &Archive::Readdir)
         .SetMethod("realpath", &Archive::Realpath)
         .SetMethod("copyFileOut", &Archive::CopyFileOut)
+        .SetMethod("read", &Archive::Read)
         .SetMethod("getFd", &Archive::GetFD)
         .SetMethod("destroy", &Archive::Destroy);
   }
 
  protected:
-  Archive(v8::Isolate* isolate, std::unique_ptr<asar::Archive> archive)
+  Archive(v8::Isolate* isolate, std::shared_ptr<asar::Archive> archive)
       : archive_(std::move(archive)) {
     Init(isolate);
   }
@@ -64,6 +73,10 @@ class Archive : public mate::Wrappable<Archive> {
     dict.Set("size", info.size);
     dict.Set("unpacked", info.unpacked);
     dict.Set("offset", info.offset);
+    if (info.compressed) {
+      dict.Set("compressed", true);
+      dict.Set("compressedSize", info.compressed_size);
+    }
     return dict.GetHandle();
   }
 
@@ -109,6 +122,24 @@ class Archive : public mate::Wrappable<Archive> {
     return mate::ConvertToV8(isolate, new_path);
   }
 
+  // Returns a Buffer pointing into the archive's read-only memory mapping.
+  // Writing to the Buffer crashes, so it must never be exposed to user code.
+  v8::Local<v8::Value> Read(v8::Isolate* isolate,
+                            uint64_t offset,
+                            uint64_t size) {
+    base::StringPiece data;
+    if (!archive_ || !archive_->GetMappedData(offset, size, &data))
+      return v8::False(isolate);
+    if (data.empty())
+      return node::Buffer::New(isolate, 0).ToLocalChecked();
+    return node::Buffer::New(isolate,
+                             const_cast<char*>(data.data()),
+                             data.size(),
+                             &FreeMappedBuffer,
+                             new std::shared_ptr<asar::Archive>(archive_))
+        .ToLocalChecked();
+  }
+
   // Return the file descriptor.
   int GetFD() const {
     if (!archive_)
@@ -116,13 +147,13 @@ class Archive : public mate::Wrappable<Archive> {
     return archive_->GetFD();
   }
 
-  // Free the resources used by archive.
+  // Release the reference to the shared archive.
   void Destroy() {
     archive_.reset();
   }
 
  private:
-  std::unique_ptr<asar::Archive> archive_;
+  std::shared_ptr<asar::Archive> archive_;
 
   DISALLOW_COPY_AND_ASSIGN(Archive);
 };
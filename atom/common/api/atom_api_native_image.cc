@@ -4,19 +4,29 @@
 
 #include "atom/common/api/atom_api_native_image.h"
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
+#include "atom/common/api/tiled_image.h"
 #include "atom/common/asar/asar_util.h"
+#include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/native_mate_converters/gfx_converter.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
+#include "atom/common/native_mate_converters/image_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
+#include "atom/common/pixel_util.h"
 #include "base/files/file_util.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/strings/pattern.h"
 #include "base/strings/string_util.h"
+#include "base/task_runner_util.h"
+#include "base/threading/thread_task_runner_handle.h"
+#include "base/threading/worker_pool.h"
 #include "native_mate/object_template_builder.h"
 #include "net/base/data_url.h"
+#include "skia/ext/image_operations.h"
 #include "third_party/skia/include/core/SkPixelRef.h"
 #include "ui/base/layout.h"
 #include "ui/base/webui/web_ui_util.h"
@@ -35,12 +45,44 @@
 
 #include "atom/common/node_includes.h"
 
+namespace {
+
+void ReleaseEncodedData(char*, void* hint) {
+  static_cast<base::RefCountedBytes*>(hint)->Release();
+}
+
+}  // namespace
+
+namespace mate {
+
+// Encoded images are handed over to the buffer instead of being copied, the
+// buffer keeps a reference until it is garbage collected.
+template<>
+struct Converter<scoped_refptr<base::RefCountedBytes>> {
+  static v8::Local<v8::Value> ToV8(
+      v8::Isolate* isolate, const scoped_refptr<base::RefCountedBytes>& val) {
+    if (!val || val->size() == 0)
+      return node::Buffer::New(isolate, 0).ToLocalChecked();
+    val->AddRef();
+    return node::Buffer::New(isolate,
+                             reinterpret_cast<char*>(val->front()),
+                             val->size(),
+                             &ReleaseEncodedData,
+                             val.get()).ToLocalChecked();
+  }
+};
+
+}  // namespace mate
+
 namespace atom {
 
 namespace api {
 
 namespace {
 
+// Default budget of decoded tiles kept by each tiled image.
+const double kDefaultTileCacheSize = 32 * 1024 * 1024;
+
 struct ScaleFactorPair {
   const char* name;
   float scale;
@@ -84,6 +126,21 @@ float GetScaleFactorFromOptions(mate::Arguments* args) {
   return scale_factor;
 }
 
+// Get the pixel format options of raw bitmaps, throws when the format is
+// not known.
+bool GetPixelFormatFromOptions(mate::Arguments* args,
+                               const mate::Dictionary& options,
+                               PixelFormat* format,
+                               bool* premultiplied) {
+  std::string name;
+  if (options.Get("format", &name) && !GetPixelFormatFromString(name, format)) {
+    args->ThrowError("Unknown pixel format: " + name);
+    return false;
+  }
+  options.Get("premultiplied", premultiplied);
+  return true;
+}
+
 bool AddImageSkiaRep(gfx::ImageSkia* image,
                      const unsigned char* data,
                      size_t size,
@@ -197,6 +254,129 @@ bool ReadImageSkiaFromICO(gfx::ImageSkia* image, HICON icon) {
 void Noop(char*, void*) {
 }
 
+using EncodedDataCallback =
+    base::Callback<void(scoped_refptr<base::RefCountedBytes>)>;
+using DataURLCallback = base::Callback<void(const std::string&)>;
+using ImageCallback = base::Callback<void(const gfx::Image&)>;
+// Template images are marked by JavaScript, as the image only gets wrapped
+// when the callback is invoked.
+using PathImageCallback = base::Callback<void(const gfx::Image&, bool)>;
+using ImageSkiaReps = std::vector<gfx::ImageSkiaRep>;
+
+// Encoding, decoding and resizing of the async methods happen on the worker
+// pool, which is available in both the browser and renderer processes.
+base::TaskRunner* GetWorkerTaskRunner() {
+  return base::WorkerPool::GetTaskRunner(true).get();
+}
+
+// The results are posted back to the calling thread, which needs a task
+// runner for that. Threads without one, like the ones of Node's workers, get
+// an error instead of a callback that never runs.
+bool CanPostToWorker(mate::Arguments* args) {
+  if (base::ThreadTaskRunnerHandle::IsSet())
+    return true;
+  args->ThrowError("Async image methods are not supported on this thread");
+  return false;
+}
+
+scoped_refptr<base::RefCountedBytes> EncodePNG(const SkBitmap& bitmap) {
+  std::vector<unsigned char> encoded;
+  gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false, &encoded);
+  return base::RefCountedBytes::TakeVector(&encoded);
+}
+
+scoped_refptr<base::RefCountedBytes> EncodeJPEG(const SkBitmap& bitmap,
+                                                int quality) {
+  std::vector<unsigned char> encoded;
+  SkAutoLockPixels bitmap_lock(bitmap);
+  if (bitmap.readyToDraw()) {
+    gfx::JPEGCodec::Encode(
+        reinterpret_cast<unsigned char*>(bitmap.getAddr32(0, 0)),
+        gfx::JPEGCodec::FORMAT_SkBitmap, bitmap.width(), bitmap.height(),
+        static_cast<int>(bitmap.rowBytes()), quality, &encoded);
+  }
+  return base::RefCountedBytes::TakeVector(&encoded);
+}
+
+std::string PNGToDataURL(scoped_refptr<base::RefCountedMemory> png) {
+  return webui::GetPngDataUrl(png->front(), png->size());
+}
+
+skia::ImageOperations::ResizeMethod GetResizeMethod(
+    const base::DictionaryValue& options) {
+  std::string quality;
+  options.GetString("quality", &quality);
+  if (quality == "good")
+    return skia::ImageOperations::ResizeMethod::RESIZE_GOOD;
+  else if (quality == "better")
+    return skia::ImageOperations::ResizeMethod::RESIZE_BETTER;
+  return skia::ImageOperations::ResizeMethod::RESIZE_BEST;
+}
+
+ImageSkiaReps ResizeImageSkiaReps(const ImageSkiaReps& reps,
+                                  skia::ImageOperations::ResizeMethod method,
+                                  const gfx::Size& size) {
+  ImageSkiaReps resized;
+  for (const gfx::ImageSkiaRep& rep : reps) {
+    gfx::Size pixel_size = gfx::ScaleToCeiledSize(size, rep.scale());
+    if (pixel_size.IsEmpty())
+      continue;
+    resized.push_back(gfx::ImageSkiaRep(
+        skia::ImageOperations::Resize(rep.sk_bitmap(), method,
+                                      pixel_size.width(), pixel_size.height()),
+        rep.scale()));
+  }
+  return resized;
+}
+
+ImageSkiaReps ReadImageSkiaRepsFromPath(const base::FilePath& path) {
+  gfx::ImageSkia image_skia;
+  PopulateImageSkiaRepsFromPath(&image_skia, NormalizePath(path));
+  return image_skia.image_reps();
+}
+
+ImageSkiaReps DecodeImageSkiaReps(const std::string& data,
+                                  int width,
+                                  int height,
+                                  double scale_factor) {
+  gfx::ImageSkia image_skia;
+  AddImageSkiaRep(&image_skia,
+                  reinterpret_cast<const unsigned char*>(data.data()),
+                  data.size(), width, height, scale_factor);
+
+  ImageSkiaReps reps;
+  for (const gfx::ImageSkiaRep& rep : image_skia.image_reps()) {
+    // Raw bitmaps point into |data|, which goes away with this task.
+    const SkBitmap& bitmap = rep.sk_bitmap();
+    if (bitmap.getPixels() != data.data()) {
+      reps.push_back(rep);
+      continue;
+    }
+    SkBitmap copy;
+    if (bitmap.getSafeSize() <= data.size() && bitmap.copyTo(&copy))
+      reps.push_back(gfx::ImageSkiaRep(copy, rep.scale()));
+  }
+  return reps;
+}
+
+gfx::Image CreateImageFromReps(const ImageSkiaReps& reps) {
+  gfx::ImageSkia image_skia;
+  for (const gfx::ImageSkiaRep& rep : reps)
+    image_skia.AddRepresentation(rep);
+  return gfx::Image(image_skia);
+}
+
+void OnImageSkiaRepsReady(const ImageCallback& callback,
+                          const ImageSkiaReps& reps) {
+  callback.Run(CreateImageFromReps(reps));
+}
+
+void OnImageSkiaRepsReadFromPath(const PathImageCallback& callback,
+                                 bool is_template,
+                                 const ImageSkiaReps& reps) {
+  callback.Run(CreateImageFromReps(reps), is_template);
+}
+
 }  // namespace
 
 NativeImage::NativeImage(v8::Isolate* isolate, const gfx::Image& image)
@@ -209,6 +389,18 @@ NativeImage::NativeImage(v8::Isolate* isolate, const gfx::Image& image)
   MarkHighMemoryUsage();
 }
 
+NativeImage::NativeImage(v8::Isolate* isolate,
+                         std::shared_ptr<TiledImage> tiled_image,
+                         const gfx::Rect& region,
+                         const gfx::Size& size,
+                         skia::ImageOperations::ResizeMethod resize_method)
+    : tiled_image_(tiled_image),
+      tiled_region_(region),
+      tiled_size_(size),
+      tiled_resize_method_(resize_method) {
+  Init(isolate);
+}
+
 #if defined(OS_WIN)
 NativeImage::NativeImage(v8::Isolate* isolate, const base::FilePath& hicon_path)
     : hicon_path_(hicon_path) {
@@ -232,6 +424,11 @@ NativeImage::~NativeImage() {
   }
 }
 
+const gfx::Image& NativeImage::image() {
+  DecodeTiledImage();
+  return image_;
+}
+
 #if defined(OS_WIN)
 HICON NativeImage::GetHICON(int size) {
   auto iter = hicons_.find(size);
@@ -245,6 +442,7 @@ HICON NativeImage::GetHICON(int size) {
   }
 
   // Then convert the image to ICO.
+  DecodeTiledImage();
   if (image_.IsEmpty())
     return NULL;
   hicons_[size] = std::move(
@@ -254,6 +452,7 @@ HICON NativeImage::GetHICON(int size) {
 #endif
 
 v8::Local<v8::Value> NativeImage::ToPNG(mate::Arguments* args) {
+  DecodeTiledImage();
   float scale_factor = GetScaleFactorFromOptions(args);
 
   if (scale_factor == 1.0f) {
@@ -268,37 +467,81 @@ v8::Local<v8::Value> NativeImage::ToPNG(mate::Arguments* args) {
 
   const SkBitmap bitmap =
       image_.AsImageSkia().GetRepresentation(scale_factor).sk_bitmap();
-  std::unique_ptr<std::vector<unsigned char>> encoded(
-      new std::vector<unsigned char>());
-  gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false, encoded.get());
-  const char* data = reinterpret_cast<char*>(encoded->data());
-  size_t size = encoded->size();
-  return node::Buffer::Copy(args->isolate(), data, size).ToLocalChecked();
+  return mate::ConvertToV8(args->isolate(), EncodePNG(bitmap));
 }
 
 v8::Local<v8::Value> NativeImage::ToBitmap(mate::Arguments* args) {
-  float scale_factor = GetScaleFactorFromOptions(args);
+  float scale_factor = 1.0f;
+  PixelFormat format = PixelFormat::BGRA;
+  bool premultiplied = true;
+  mate::Dictionary options;
+  if (args->GetNext(&options)) {
+    options.Get("scaleFactor", &scale_factor);
+    if (!GetPixelFormatFromOptions(args, options, &format, &premultiplied))
+      return v8::Undefined(args->isolate());
+  }
+  bool is_native_format = format == PixelFormat::BGRA && premultiplied;
+
+  SkBitmap bitmap;
+  if (tiled_image_) {
+    SkImageInfo info = SkImageInfo::MakeN32(
+        tiled_size_.width(), tiled_size_.height(),
+        tiled_image_->is_opaque() ? kOpaque_SkAlphaType : kPremul_SkAlphaType);
+    if (is_native_format) {
+      // Decode the shown region right into the buffer.
+      v8::Local<v8::Object> buffer;
+      size_t length = static_cast<size_t>(tiled_size_.width()) *
+                      tiled_size_.height() * 4;
+      if (!node::Buffer::New(args->isolate(), length).ToLocal(&buffer))
+        return v8::Null(args->isolate());
+      bitmap.installPixels(info, node::Buffer::Data(buffer),
+                           tiled_size_.width() * 4);
+      // The buffer is not initialized, never hand it out undecoded.
+      if (!tiled_image_->Draw(tiled_region_, tiled_resize_method_, &bitmap))
+        return node::Buffer::New(args->isolate(), 0).ToLocalChecked();
+      return buffer;
+    }
+    if (!bitmap.tryAllocPixels(info) ||
+        !tiled_image_->Draw(tiled_region_, tiled_resize_method_, &bitmap))
+      bitmap.reset();
+  } else {
+    bitmap = image_.AsImageSkia().GetRepresentation(scale_factor).sk_bitmap();
+  }
 
-  const SkBitmap bitmap =
-      image_.AsImageSkia().GetRepresentation(scale_factor).sk_bitmap();
-  SkPixelRef* ref = bitmap.pixelRef();
-  if (!ref)
-    return node::Buffer::New(args->isolate(), 0).ToLocalChecked();
-  return node::Buffer::Copy(args->isolate(),
-                            reinterpret_cast<const char*>(ref->pixels()),
-                            bitmap.getSafeSize()).ToLocalChecked();
+  if (is_native_format) {
+    SkPixelRef* ref = bitmap.pixelRef();
+    if (!ref)
+      return node::Buffer::New(args->isolate(), 0).ToLocalChecked();
+    return node::Buffer::Copy(args->isolate(),
+                              reinterpret_cast<const char*>(ref->pixels()),
+                              bitmap.getSafeSize()).ToLocalChecked();
+  }
+
+  // Other formats are converted straight into the buffer.
+  int stride = bitmap.width() * GetBytesPerPixel(format);
+  v8::Local<v8::Object> buffer;
+  if (!node::Buffer::New(args->isolate(),
+                         static_cast<size_t>(stride) * bitmap.height())
+          .ToLocal(&buffer))
+    return v8::Null(args->isolate());
+  if (!bitmap.drawsNothing()) {
+    ConvertFromN32(bitmap, format, premultiplied,
+                   reinterpret_cast<uint8_t*>(node::Buffer::Data(buffer)),
+                   stride);
+  }
+  return buffer;
 }
 
 v8::Local<v8::Value> NativeImage::ToJPEG(v8::Isolate* isolate, int quality) {
+  DecodeTiledImage();
   std::vector<unsigned char> output;
   gfx::JPEG1xEncodedDataFromImage(image_, quality, &output);
-  return node::Buffer::Copy(
-      isolate,
-      reinterpret_cast<const char*>(&output.front()),
-      output.size()).ToLocalChecked();
+  return mate::ConvertToV8(isolate,
+                           base::RefCountedBytes::TakeVector(&output));
 }
 
 std::string NativeImage::ToDataURL(mate::Arguments* args) {
+  DecodeTiledImage();
   float scale_factor = GetScaleFactorFromOptions(args);
 
   if (scale_factor == 1.0f) {
@@ -313,6 +556,7 @@ std::string NativeImage::ToDataURL(mate::Arguments* args) {
 }
 
 v8::Local<v8::Value> NativeImage::GetBitmap(mate::Arguments* args) {
+  DecodeTiledImage();
   float scale_factor = GetScaleFactorFromOptions(args);
 
   const SkBitmap bitmap =
@@ -330,6 +574,7 @@ v8::Local<v8::Value> NativeImage::GetBitmap(mate::Arguments* args) {
 v8::Local<v8::Value> NativeImage::GetNativeHandle(v8::Isolate* isolate,
                                                   mate::Arguments* args) {
 #if defined(OS_MACOSX)
+  DecodeTiledImage();
   if (IsEmpty()) return node::Buffer::New(isolate, 0).ToLocalChecked();
 
   NSImage* ptr = image_.AsNSImage();
@@ -344,10 +589,14 @@ v8::Local<v8::Value> NativeImage::GetNativeHandle(v8::Isolate* isolate,
 }
 
 bool NativeImage::IsEmpty() {
+  if (tiled_image_)
+    return tiled_size_.IsEmpty();
   return image_.IsEmpty();
 }
 
 gfx::Size NativeImage::GetSize() {
+  if (tiled_image_)
+    return tiled_size_;
   return image_.Size();
 }
 
@@ -361,40 +610,32 @@ float NativeImage::GetAspectRatio() {
 
 mate::Handle<NativeImage> NativeImage::Resize(
     v8::Isolate* isolate, const base::DictionaryValue& options) {
-  gfx::Size size = GetSize();
-  int width = size.width();
-  int height = size.height();
-  bool width_set = options.GetInteger("width", &width);
-  bool height_set = options.GetInteger("height", &height);
-  size.SetSize(width, height);
+  gfx::Size size = GetResizedSize(options);
 
-  if (width_set && !height_set) {
-    // Scale height to preserve original aspect ratio
-    size.set_height(width);
-    size = gfx::ScaleToRoundedSize(size, 1.f, 1.f / GetAspectRatio());
-  } else if (height_set && !width_set) {
-    // Scale width to preserve original aspect ratio
-    size.set_width(height);
-    size = gfx::ScaleToRoundedSize(size, GetAspectRatio(), 1.f);
+  // Tiled images only decode the resized region when drawn.
+  if (tiled_image_) {
+    return mate::CreateHandle(
+        isolate, new NativeImage(isolate, tiled_image_, tiled_region_, size,
+                                 GetResizeMethod(options)));
   }
 
-  skia::ImageOperations::ResizeMethod method =
-      skia::ImageOperations::ResizeMethod::RESIZE_BEST;
-  std::string quality;
-  options.GetString("quality", &quality);
-  if (quality == "good")
-    method = skia::ImageOperations::ResizeMethod::RESIZE_GOOD;
-  else if (quality == "better")
-    method = skia::ImageOperations::ResizeMethod::RESIZE_BETTER;
-
   gfx::ImageSkia resized = gfx::ImageSkiaOperations::CreateResizedImage(
-      image_.AsImageSkia(), method, size);
+      image_.AsImageSkia(), GetResizeMethod(options), size);
   return mate::CreateHandle(isolate,
                             new NativeImage(isolate, gfx::Image(resized)));
 }
 
 mate::Handle<NativeImage> NativeImage::Crop(v8::Isolate* isolate,
                                             const gfx::Rect& rect) {
+  if (tiled_image_) {
+    gfx::Rect cropped(rect);
+    cropped.Intersect(gfx::Rect(tiled_size_));
+    return mate::CreateHandle(
+        isolate, new NativeImage(isolate, tiled_image_,
+                                 GetTiledRegion(cropped), cropped.size(),
+                                 tiled_resize_method_));
+  }
+
   gfx::ImageSkia cropped = gfx::ImageSkiaOperations::ExtractSubset(
       image_.AsImageSkia(), rect);
   return mate::CreateHandle(isolate,
@@ -402,6 +643,7 @@ mate::Handle<NativeImage> NativeImage::Crop(v8::Isolate* isolate,
 }
 
 void NativeImage::AddRepresentation(const mate::Dictionary& options) {
+  DecodeTiledImage();
   int width = 0;
   int height = 0;
   float scale_factor = 1.0f;
@@ -442,6 +684,156 @@ void NativeImage::AddRepresentation(const mate::Dictionary& options) {
   }
 }
 
+v8::Local<v8::Value> NativeImage::ToPNGAsync(mate::Arguments* args) {
+  DecodeTiledImage();
+  float scale_factor = GetScaleFactorFromOptions(args);
+  EncodedDataCallback callback;
+  if (!args->GetNext(&callback)) {
+    args->ThrowError();
+    return v8::Undefined(args->isolate());
+  }
+
+  // Copying the already encoded data is cheaper than posting it around.
+  if (scale_factor == 1.0f &&
+      image_.HasRepresentation(gfx::Image::kImageRepPNG)) {
+    scoped_refptr<base::RefCountedMemory> png = image_.As1xPNGBytes();
+    return node::Buffer::Copy(args->isolate(),
+                              reinterpret_cast<const char*>(png->front()),
+                              png->size()).ToLocalChecked();
+  }
+
+  if (!CanPostToWorker(args))
+    return v8::Undefined(args->isolate());
+  const SkBitmap bitmap =
+      image_.AsImageSkia().GetRepresentation(scale_factor).sk_bitmap();
+  base::PostTaskAndReplyWithResult(
+      GetWorkerTaskRunner(), FROM_HERE, base::Bind(&EncodePNG, bitmap),
+      callback);
+  return v8::Undefined(args->isolate());
+}
+
+void NativeImage::ToJPEGAsync(mate::Arguments* args) {
+  DecodeTiledImage();
+  int quality = 0;
+  EncodedDataCallback callback;
+  if (!args->GetNext(&quality) || !args->GetNext(&callback)) {
+    args->ThrowError();
+    return;
+  }
+  if (!CanPostToWorker(args))
+    return;
+
+  // Same with gfx::JPEG1xEncodedDataFromImage, only the 1x bitmap is used.
+  SkBitmap bitmap;
+  const gfx::ImageSkiaRep& rep = image_.AsImageSkia().GetRepresentation(1.0f);
+  if (rep.scale() == 1.0f)
+    bitmap = rep.sk_bitmap();
+  base::PostTaskAndReplyWithResult(
+      GetWorkerTaskRunner(), FROM_HERE,
+      base::Bind(&EncodeJPEG, bitmap, quality), callback);
+}
+
+void NativeImage::ToDataURLAsync(mate::Arguments* args) {
+  DecodeTiledImage();
+  float scale_factor = GetScaleFactorFromOptions(args);
+  DataURLCallback callback;
+  if (!args->GetNext(&callback)) {
+    args->ThrowError();
+    return;
+  }
+  if (!CanPostToWorker(args))
+    return;
+
+  if (scale_factor == 1.0f &&
+      image_.HasRepresentation(gfx::Image::kImageRepPNG)) {
+    base::PostTaskAndReplyWithResult(
+        GetWorkerTaskRunner(), FROM_HERE,
+        base::Bind(&PNGToDataURL, image_.As1xPNGBytes()), callback);
+    return;
+  }
+
+  const SkBitmap bitmap =
+      image_.AsImageSkia().GetRepresentation(scale_factor).sk_bitmap();
+  base::PostTaskAndReplyWithResult(
+      GetWorkerTaskRunner(), FROM_HERE,
+      base::Bind(&webui::GetBitmapDataUrl, bitmap), callback);
+}
+
+v8::Local<v8::Value> NativeImage::ResizeAsync(mate::Arguments* args) {
+  base::DictionaryValue options;
+  ImageCallback callback;
+  if (!args->GetNext(&options) || !args->GetNext(&callback)) {
+    args->ThrowError();
+    return v8::Undefined(args->isolate());
+  }
+
+  // Resizing tiled images does not decode anything, so there is nothing to
+  // wait for.
+  if (tiled_image_) {
+    return mate::ConvertToV8(args->isolate(),
+                             Resize(args->isolate(), options));
+  }
+
+  if (!CanPostToWorker(args))
+    return v8::Undefined(args->isolate());
+  gfx::Size size = GetResizedSize(options);
+  gfx::ImageSkia image_skia = image_.AsImageSkia();
+  image_skia.EnsureRepsForSupportedScales();
+  base::PostTaskAndReplyWithResult(
+      GetWorkerTaskRunner(), FROM_HERE,
+      base::Bind(&ResizeImageSkiaReps, image_skia.image_reps(),
+                 GetResizeMethod(options), size),
+      base::Bind(&OnImageSkiaRepsReady, callback));
+  return v8::Undefined(args->isolate());
+}
+
+gfx::Size NativeImage::GetResizedSize(const base::DictionaryValue& options) {
+  gfx::Size size = GetSize();
+  int width = size.width();
+  int height = size.height();
+  bool width_set = options.GetInteger("width", &width);
+  bool height_set = options.GetInteger("height", &height);
+  size.SetSize(width, height);
+
+  if (width_set && !height_set) {
+    // Scale height to preserve original aspect ratio
+    size.set_height(width);
+    size = gfx::ScaleToRoundedSize(size, 1.f, 1.f / GetAspectRatio());
+  } else if (height_set && !width_set) {
+    // Scale width to preserve original aspect ratio
+    size.set_width(height);
+    size = gfx::ScaleToRoundedSize(size, GetAspectRatio(), 1.f);
+  }
+  return size;
+}
+
+void NativeImage::DecodeTiledImage() {
+  if (!tiled_image_)
+    return;
+
+  SkBitmap bitmap;
+  if (bitmap.tryAllocN32Pixels(tiled_size_.width(), tiled_size_.height(),
+                               tiled_image_->is_opaque()) &&
+      tiled_image_->Draw(tiled_region_, tiled_resize_method_, &bitmap)) {
+    image_ = gfx::Image::CreateFrom1xBitmap(bitmap);
+    isolate()->AdjustAmountOfExternalAllocatedMemory(bitmap.computeSize64());
+  }
+  tiled_image_.reset();
+}
+
+gfx::Rect NativeImage::GetTiledRegion(const gfx::Rect& rect) const {
+  if (tiled_size_.IsEmpty())
+    return gfx::Rect();
+
+  gfx::Rect region = gfx::ScaleToEnclosingRect(
+      rect,
+      static_cast<float>(tiled_region_.width()) / tiled_size_.width(),
+      static_cast<float>(tiled_region_.height()) / tiled_size_.height());
+  region.Offset(tiled_region_.x(), tiled_region_.y());
+  region.Intersect(tiled_region_);
+  return region;
+}
+
 #if !defined(OS_MACOSX)
 void NativeImage::SetTemplateImage(bool setAsTemplate) {
 }
@@ -508,6 +900,11 @@ mate::Handle<NativeImage> NativeImage::CreateFromBuffer(
 
   mate::Dictionary options;
   if (args->GetNext(&options)) {
+    bool tiled = false;
+    if (options.Get("tiled", &tiled) && tiled) {
+      return CreateTiled(args->isolate(), node::Buffer::Data(buffer),
+                         node::Buffer::Length(buffer), options);
+    }
     options.Get("width", &width);
     options.Get("height", &height);
     options.Get("scaleFactor", &scale_factor);
@@ -526,6 +923,48 @@ mate::Handle<NativeImage> NativeImage::CreateFromBuffer(
   return Create(args->isolate(), gfx::Image(image_skia));
 }
 
+// static
+mate::Handle<NativeImage> NativeImage::CreateFromBitmap(
+    mate::Arguments* args, v8::Local<v8::Value> buffer) {
+  if (!node::Buffer::HasInstance(buffer)) {
+    args->ThrowError("buffer must be a node Buffer");
+    return CreateEmpty(args->isolate());
+  }
+
+  int width = 0;
+  int height = 0;
+  double scale_factor = 1.;
+  PixelFormat format = PixelFormat::BGRA;
+  bool premultiplied = true;
+  mate::Dictionary options;
+  if (!args->GetNext(&options) ||
+      !options.Get("width", &width) || !options.Get("height", &height)) {
+    args->ThrowError("width and height are required");
+    return CreateEmpty(args->isolate());
+  }
+  options.Get("scaleFactor", &scale_factor);
+  if (!GetPixelFormatFromOptions(args, options, &format, &premultiplied))
+    return CreateEmpty(args->isolate());
+  if (width <= 0 || height <= 0)
+    return CreateEmpty(args->isolate());
+
+  uint64_t stride = static_cast<uint64_t>(width) * GetBytesPerPixel(format);
+  if (stride * height > node::Buffer::Length(buffer)) {
+    args->ThrowError("buffer is smaller than width * height pixels");
+    return CreateEmpty(args->isolate());
+  }
+
+  SkBitmap bitmap;
+  if (!ConvertToN32(reinterpret_cast<uint8_t*>(node::Buffer::Data(buffer)),
+                    static_cast<int>(stride), format, premultiplied,
+                    width, height, &bitmap))
+    return CreateEmpty(args->isolate());
+
+  gfx::ImageSkia image_skia;
+  image_skia.AddRepresentation(gfx::ImageSkiaRep(bitmap, scale_factor));
+  return Create(args->isolate(), gfx::Image(image_skia));
+}
+
 // static
 mate::Handle<NativeImage> NativeImage::CreateFromDataURL(
     v8::Isolate* isolate, const GURL& url) {
@@ -540,6 +979,96 @@ mate::Handle<NativeImage> NativeImage::CreateFromDataURL(
   return CreateEmpty(isolate);
 }
 
+// static
+mate::Handle<NativeImage> NativeImage::CreateTiled(
+    v8::Isolate* isolate, const char* buffer, size_t length,
+    const mate::Dictionary& options) {
+  double cache_size = kDefaultTileCacheSize;
+  options.Get("tileCacheSize", &cache_size);
+  std::shared_ptr<TiledImage> tiled_image = TiledImage::Create(
+      buffer, length, static_cast<size_t>(std::max(cache_size, 0.0)));
+  if (!tiled_image) {
+    gfx::ImageSkia image_skia;
+    AddImageSkiaRep(&image_skia,
+                    reinterpret_cast<const unsigned char*>(buffer), length,
+                    0, 0, 1.0f);
+    return Create(isolate, gfx::Image(image_skia));
+  }
+
+  gfx::Size size = tiled_image->size();
+  return mate::CreateHandle(
+      isolate, new NativeImage(isolate, tiled_image, gfx::Rect(size), size,
+                               skia::ImageOperations::RESIZE_BEST));
+}
+
+// static
+v8::Local<v8::Value> NativeImage::CreateFromPathAsync(mate::Arguments* args) {
+  base::FilePath path;
+  PathImageCallback callback;
+  if (!args->GetNext(&path) || !args->GetNext(&callback)) {
+    args->ThrowError();
+    return v8::Undefined(args->isolate());
+  }
+
+#if defined(OS_WIN)
+  // Icons are loaded by the system in the sizes being used.
+  if (path.MatchesExtension(FILE_PATH_LITERAL(".ico")))
+    return mate::ConvertToV8(args->isolate(),
+                             CreateFromPath(args->isolate(), path));
+#endif
+
+  if (!CanPostToWorker(args))
+    return v8::Undefined(args->isolate());
+  bool is_template = false;
+#if defined(OS_MACOSX)
+  is_template = IsTemplateFilename(path);
+#endif
+  base::PostTaskAndReplyWithResult(
+      GetWorkerTaskRunner(), FROM_HERE,
+      base::Bind(&ReadImageSkiaRepsFromPath, path),
+      base::Bind(&OnImageSkiaRepsReadFromPath, callback, is_template));
+  return v8::Undefined(args->isolate());
+}
+
+// static
+v8::Local<v8::Value> NativeImage::CreateFromBufferAsync(
+    mate::Arguments* args) {
+  v8::Local<v8::Value> buffer;
+  mate::Dictionary options;
+  ImageCallback callback;
+  if (!args->GetNext(&buffer) || !node::Buffer::HasInstance(buffer) ||
+      !args->GetNext(&options) || !args->GetNext(&callback)) {
+    args->ThrowError();
+    return v8::Undefined(args->isolate());
+  }
+
+  // Tiled images are decoded when drawn.
+  bool tiled = false;
+  if (options.Get("tiled", &tiled) && tiled) {
+    return mate::ConvertToV8(
+        args->isolate(),
+        CreateTiled(args->isolate(), node::Buffer::Data(buffer),
+                    node::Buffer::Length(buffer), options));
+  }
+
+  if (!CanPostToWorker(args))
+    return v8::Undefined(args->isolate());
+  int width = 0;
+  int height = 0;
+  double scale_factor = 1.;
+  options.Get("width", &width);
+  options.Get("height", &height);
+  options.Get("scaleFactor", &scale_factor);
+
+  // The buffer may be changed or collected before the task runs.
+  std::string data(node::Buffer::Data(buffer), node::Buffer::Length(buffer));
+  base::PostTaskAndReplyWithResult(
+      GetWorkerTaskRunner(), FROM_HERE,
+      base::Bind(&DecodeImageSkiaReps, data, width, height, scale_factor),
+      base::Bind(&OnImageSkiaRepsReady, callback));
+  return v8::Undefined(args->isolate());
+}
+
 // static
 void NativeImage::BuildPrototype(
     v8::Isolate* isolate, v8::Local<v8::FunctionTemplate> prototype) {
@@ -551,6 +1080,10 @@ void NativeImage::BuildPrototype(
       .SetMethod("getBitmap", &NativeImage::GetBitmap)
       .SetMethod("getNativeHandle", &NativeImage::GetNativeHandle)
       .SetMethod("toDataURL", &NativeImage::ToDataURL)
+      .SetMethod("_toPNGAsync", &NativeImage::ToPNGAsync)
+      .SetMethod("_toJPEGAsync", &NativeImage::ToJPEGAsync)
+      .SetMethod("_toDataURLAsync", &NativeImage::ToDataURLAsync)
+      .SetMethod("_resizeAsync", &NativeImage::ResizeAsync)
       .SetMethod("isEmpty", &NativeImage::IsEmpty)
       .SetMethod("getSize", &NativeImage::GetSize)
       .SetMethod("setTemplateImage", &NativeImage::SetTemplateImage)
@@ -600,14 +1133,33 @@ bool Converter<mate::Handle<atom::api::NativeImage>>::FromV8(
 
 namespace {
 
+mate::Handle<atom::api::NativeImage> CreateFromPath(
+    mate::Arguments* args, const base::FilePath& path) {
+  mate::Dictionary options;
+  bool tiled = false;
+  if (!args->GetNext(&options) || !options.Get("tiled", &tiled) || !tiled)
+    return atom::api::NativeImage::CreateFromPath(args->isolate(), path);
+
+  std::string contents;
+  if (!asar::ReadFileToString(path, &contents))
+    return atom::api::NativeImage::CreateEmpty(args->isolate());
+  return atom::api::NativeImage::CreateTiled(
+      args->isolate(), contents.data(), contents.size(), options);
+}
+
 void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
                 v8::Local<v8::Context> context, void* priv) {
   mate::Dictionary dict(context->GetIsolate(), exports);
   dict.SetMethod("createEmpty", &atom::api::NativeImage::CreateEmpty);
-  dict.SetMethod("createFromPath", &atom::api::NativeImage::CreateFromPath);
+  dict.SetMethod("createFromPath", &CreateFromPath);
   dict.SetMethod("createFromBuffer", &atom::api::NativeImage::CreateFromBuffer);
+  dict.SetMethod("createFromBitmap", &atom::api::NativeImage::CreateFromBitmap);
   dict.SetMethod("createFromDataURL",
                  &atom::api::NativeImage::CreateFromDataURL);
+  dict.SetMethod("_createFromPathAsync",
+                 &atom::api::NativeImage::CreateFromPathAsync);
+  dict.SetMethod("_createFromBufferAsync",
+                 &atom::api::NativeImage::CreateFromBufferAsync);
 }
 
 }  // namespace
@@ -6,12 +6,14 @@
 #define ATOM_COMMON_API_ATOM_API_NATIVE_IMAGE_H_
 
 #include <map>
+#include <memory>
 #include <string>
 
 #include "base/values.h"
 #include "native_mate/dictionary.h"
 #include "native_mate/handle.h"
 #include "native_mate/wrappable.h"
+#include "skia/ext/image_operations.h"
 #include "ui/gfx/geometry/rect.h"
 #include "ui/gfx/image/image.h"
 
@@ -36,6 +38,8 @@ class Arguments;
 
 namespace atom {
 
+class TiledImage;
+
 namespace api {
 
 class NativeImage : public mate::Wrappable<NativeImage> {
@@ -51,8 +55,20 @@ class NativeImage : public mate::Wrappable<NativeImage> {
       v8::Isolate* isolate, const base::FilePath& path);
   static mate::Handle<NativeImage> CreateFromBuffer(
       mate::Arguments* args, v8::Local<v8::Value> buffer);
+  // Creates an image from raw pixels in any of the PixelFormats.
+  static mate::Handle<NativeImage> CreateFromBitmap(
+      mate::Arguments* args, v8::Local<v8::Value> buffer);
   static mate::Handle<NativeImage> CreateFromDataURL(
       v8::Isolate* isolate, const GURL& url);
+  // Keeps the encoded image and decodes the parts being used, falls back to
+  // decoding the whole image when it can not be tiled.
+  static mate::Handle<NativeImage> CreateTiled(
+      v8::Isolate* isolate, const char* buffer, size_t length,
+      const mate::Dictionary& options);
+  // Decode on the worker pool and pass the image to the callback argument,
+  // images that need no decoding yet are returned right away instead.
+  static v8::Local<v8::Value> CreateFromPathAsync(mate::Arguments* args);
+  static v8::Local<v8::Value> CreateFromBufferAsync(mate::Arguments* args);
 
   static void BuildPrototype(v8::Isolate* isolate,
                              v8::Local<v8::FunctionTemplate> prototype);
@@ -61,10 +77,17 @@ class NativeImage : public mate::Wrappable<NativeImage> {
   HICON GetHICON(int size);
 #endif
 
-  const gfx::Image& image() const { return image_; }
+  // Decodes tiled images as a whole.
+  const gfx::Image& image();
 
  protected:
   NativeImage(v8::Isolate* isolate, const gfx::Image& image);
+  // Shows |region| of |tiled_image| scaled to |size| with |resize_method|.
+  NativeImage(v8::Isolate* isolate,
+              std::shared_ptr<TiledImage> tiled_image,
+              const gfx::Rect& region,
+              const gfx::Size& size,
+              skia::ImageOperations::ResizeMethod resize_method);
 #if defined(OS_WIN)
   NativeImage(v8::Isolate* isolate, const base::FilePath& hicon_path);
 #endif
@@ -83,6 +106,12 @@ class NativeImage : public mate::Wrappable<NativeImage> {
   mate::Handle<NativeImage> Crop(v8::Isolate* isolate,
                                  const gfx::Rect& rect);
   std::string ToDataURL(mate::Arguments* args);
+  // Same with the methods above but done on the worker pool, the result is
+  // passed to the callback argument.
+  v8::Local<v8::Value> ToPNGAsync(mate::Arguments* args);
+  void ToJPEGAsync(mate::Arguments* args);
+  void ToDataURLAsync(mate::Arguments* args);
+  v8::Local<v8::Value> ResizeAsync(mate::Arguments* args);
   bool IsEmpty();
   gfx::Size GetSize();
   float GetAspectRatio();
@@ -93,6 +122,14 @@ class NativeImage : public mate::Wrappable<NativeImage> {
   // Determine if the image is a template image.
   bool IsTemplateImage();
 
+  // Size of the image after resizing with |options|.
+  gfx::Size GetResizedSize(const base::DictionaryValue& options);
+
+  // Draws a tiled image into |image_| and turns it into a normal one.
+  void DecodeTiledImage();
+  // Maps |rect| of the tiled image to its source region.
+  gfx::Rect GetTiledRegion(const gfx::Rect& rect) const;
+
 #if defined(OS_WIN)
   base::FilePath hicon_path_;
   std::map<int, base::win::ScopedHICON> hicons_;
@@ -100,6 +137,12 @@ class NativeImage : public mate::Wrappable<NativeImage> {
 
   gfx::Image image_;
 
+  // Only set for tiled images, which are decoded when drawn.
+  std::shared_ptr<TiledImage> tiled_image_;
+  gfx::Rect tiled_region_;
+  gfx::Size tiled_size_;
+  skia::ImageOperations::ResizeMethod tiled_resize_method_;
+
   DISALLOW_COPY_AND_ASSIGN(NativeImage);
 };
 
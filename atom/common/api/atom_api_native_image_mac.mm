@@ -11,10 +11,12 @@ namespace atom {
 namespace api {
 
 void NativeImage::SetTemplateImage(bool setAsTemplate) {
+  DecodeTiledImage();
   [image_.AsNSImage() setTemplate:setAsTemplate];
 }
 
 bool NativeImage::IsTemplateImage() {
+  DecodeTiledImage();
   return [image_.AsNSImage() isTemplate];
 }
 
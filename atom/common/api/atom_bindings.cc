@@ -8,6 +8,7 @@
 #include <iostream>
 #include <string>
 
+#include "atom/common/asar/asar_util.h"
 #include "atom/common/atom_version.h"
 #include "atom/common/chrome_version.h"
 #include "atom/common/native_mate_converters/string16_converter.h"
@@ -56,6 +57,7 @@ void AtomBindings::BindTo(v8::Isolate* isolate,
   dict.SetMethod("getCPUUsage",
       base::Bind(&AtomBindings::GetCPUUsage, base::Unretained(this)));
   dict.SetMethod("getIOCounters", &GetIOCounters);
+  dict.SetMethod("getAsarCacheStats", &GetAsarCacheStats);
 #if defined(OS_POSIX)
   dict.SetMethod("setFdLimit", &base::SetFdLimit);
 #endif
@@ -204,4 +206,15 @@ v8::Local<v8::Value> AtomBindings::GetIOCounters(v8::Isolate* isolate) {
   return dict.GetHandle();
 }
 
+// static
+v8::Local<v8::Value> AtomBindings::GetAsarCacheStats(v8::Isolate* isolate) {
+  asar::ArchiveCacheStats stats;
+  asar::GetArchiveCacheStats(&stats);
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
+  dict.Set("archives", static_cast<uint32_t>(stats.archives));
+  dict.Set("hits", stats.hits);
+  dict.Set("misses", stats.misses);
+  return dict.GetHandle();
+}
+
 }  // namespace atom
@@ -40,6 +40,7 @@ class AtomBindings {
       mate::Arguments* args);
   v8::Local<v8::Value> GetCPUUsage(v8::Isolate* isolate);
   static v8::Local<v8::Value> GetIOCounters(v8::Isolate* isolate);
+  static v8::Local<v8::Value> GetAsarCacheStats(v8::Isolate* isolate);
 
  private:
   void ActivateUVLoop(v8::Isolate* isolate);
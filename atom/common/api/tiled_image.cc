@@ -0,0 +1,215 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/api/tiled_image.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/memory/ptr_util.h"
+#include "third_party/skia/include/codec/SkCodec.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkPaint.h"
+
+namespace atom {
+
+namespace {
+
+// Width and height of tiles in pixels.
+const int kTileSize = 256;
+
+// JPEG can be decoded at up to 1/8 of its size.
+const int kMaxLevel = 3;
+
+}  // namespace
+
+// static
+std::unique_ptr<TiledImage> TiledImage::Create(const char* data,
+                                               size_t length,
+                                               size_t cache_size) {
+  sk_sp<SkData> encoded = SkData::MakeWithCopy(data, length);
+  std::unique_ptr<SkCodec> codec(SkCodec::NewFromData(encoded));
+  if (!codec)
+    return nullptr;
+
+  SkEncodedFormat format = codec->getEncodedFormat();
+  if ((format != kPNG_SkEncodedFormat && format != kJPEG_SkEncodedFormat) ||
+      codec->getScanlineOrder() != SkCodec::kTopDown_SkScanlineOrder ||
+      codec->getInfo().isEmpty())
+    return nullptr;
+
+  return base::WrapUnique(
+      new TiledImage(std::move(encoded), std::move(codec), cache_size));
+}
+
+TiledImage::TiledImage(sk_sp<SkData> data,
+                       std::unique_ptr<SkCodec> codec,
+                       size_t cache_size)
+    : data_(std::move(data)),
+      codec_(std::move(codec)),
+      is_opaque_(codec_->getInfo().alphaType() == kOpaque_SkAlphaType),
+      tiles_(base::MRUCache<TileKey, SkBitmap>::NO_AUTO_EVICT),
+      cache_size_(cache_size),
+      cached_bytes_(0) {
+  const SkImageInfo& info = codec_->getInfo();
+  level_sizes_.push_back(gfx::Size(info.width(), info.height()));
+  for (int level = 1; level <= kMaxLevel; ++level) {
+    SkISize size = codec_->getScaledDimensions(1.f / (1 << level));
+    if (gfx::Size(size.width(), size.height()) == level_sizes_.back())
+      break;
+    level_sizes_.push_back(gfx::Size(size.width(), size.height()));
+  }
+}
+
+TiledImage::~TiledImage() {
+}
+
+bool TiledImage::Draw(const gfx::Rect& region,
+                      skia::ImageOperations::ResizeMethod method,
+                      SkBitmap* bitmap) {
+  gfx::Rect source(region);
+  source.Intersect(gfx::Rect(size()));
+  if (source.IsEmpty() || bitmap->drawsNothing())
+    return false;
+
+  int level = GetLevel(
+      static_cast<float>(bitmap->width()) / source.width(),
+      static_cast<float>(bitmap->height()) / source.height());
+  const gfx::Size& level_size = level_sizes_[level];
+  float level_scale_x = static_cast<float>(level_size.width()) / size().width();
+  float level_scale_y =
+      static_cast<float>(level_size.height()) / size().height();
+  gfx::Rect level_region =
+      gfx::ScaleToEnclosingRect(source, level_scale_x, level_scale_y);
+  level_region.Intersect(gfx::Rect(level_size));
+  if (level_region.IsEmpty())
+    return false;
+
+  // Scaling the tiles one by one would sample each of them only up to its
+  // own edges and leave seams, so they are put together at |level| and the
+  // result is scaled once, the same way resize() scales normal images.
+  const bool scaled =
+      level_region.size() != gfx::Size(bitmap->width(), bitmap->height());
+  SkBitmap level_bitmap;
+  if (scaled &&
+      !level_bitmap.tryAllocPixels(bitmap->info().makeWH(
+          level_region.width(), level_region.height())))
+    return false;
+
+  // Tiles are drawn at their own position and clipped by the canvas.
+  SkCanvas canvas(scaled ? level_bitmap : *bitmap);
+  canvas.translate(-level_region.x(), -level_region.y());
+  SkPaint paint;
+  paint.setBlendMode(SkBlendMode::kSrc);
+
+  int first_column = level_region.x() / kTileSize;
+  int last_column = (level_region.right() - 1) / kTileSize;
+  int first_row = level_region.y() / kTileSize;
+  int last_row = (level_region.bottom() - 1) / kTileSize;
+  // The scanline decoder only moves forward, it is started on the first
+  // missing tile and then reused for all following rows.
+  int next_line = -1;
+  for (int row = first_row; row <= last_row; ++row) {
+    std::vector<int> missing;
+    for (int column = first_column; column <= last_column; ++column) {
+      auto it = tiles_.Get(TileKey(level, column, row));
+      if (it == tiles_.end())
+        missing.push_back(column);
+      else
+        canvas.drawBitmap(it->second, column * kTileSize, row * kTileSize,
+                          &paint);
+    }
+    if (missing.empty())
+      continue;
+
+    // Tiles are drawn straight from the decoded band, so they are drawn even
+    // when they do not fit in the cache.
+    std::vector<SkBitmap> decoded;
+    if (!DecodeTiles(level, row, missing, &next_line, &decoded))
+      return false;
+    for (size_t i = 0; i < missing.size(); ++i)
+      canvas.drawBitmap(decoded[i], missing[i] * kTileSize, row * kTileSize,
+                        &paint);
+  }
+
+  if (scaled) {
+    SkBitmap resized = skia::ImageOperations::Resize(
+        level_bitmap, method, bitmap->width(), bitmap->height());
+    if (resized.drawsNothing())
+      return false;
+    SkCanvas(*bitmap).drawBitmap(resized, 0, 0, &paint);
+  }
+  return true;
+}
+
+int TiledImage::GetLevel(float scale_x, float scale_y) const {
+  for (int level = static_cast<int>(level_sizes_.size()) - 1; level > 0;
+       --level) {
+    const gfx::Size& level_size = level_sizes_[level];
+    if (level_size.width() >= size().width() * scale_x &&
+        level_size.height() >= size().height() * scale_y)
+      return level;
+  }
+  return 0;
+}
+
+bool TiledImage::DecodeTiles(int level, int row,
+                             const std::vector<int>& columns,
+                             int* next_line,
+                             std::vector<SkBitmap>* tiles) {
+  const gfx::Size& level_size = level_sizes_[level];
+  SkImageInfo info = SkImageInfo::MakeN32(
+      level_size.width(), level_size.height(),
+      is_opaque_ ? kOpaque_SkAlphaType : kPremul_SkAlphaType);
+  if (*next_line < 0) {
+    if (codec_->startScanlineDecode(info) != SkCodec::kSuccess)
+      return false;
+    *next_line = 0;
+  }
+
+  int top = row * kTileSize;
+  int bottom = std::min(top + kTileSize, level_size.height());
+  if (top > *next_line && !codec_->skipScanlines(top - *next_line))
+    return false;
+
+  // Only one band of rows is decoded at a time, incomplete images leave the
+  // missing rows zeroed.
+  SkBitmap band;
+  if (!band.tryAllocPixels(info.makeWH(level_size.width(), bottom - top)))
+    return false;
+  band.eraseColor(SK_ColorTRANSPARENT);
+  codec_->getScanlines(band.getPixels(), bottom - top, band.rowBytes());
+  *next_line = bottom;
+
+  for (int column : columns) {
+    int left = column * kTileSize;
+    int width = std::min(kTileSize, level_size.width() - left);
+    SkBitmap tile;
+    if (!tile.tryAllocPixels(info.makeWH(width, bottom - top)) ||
+        !band.readPixels(tile.info(), tile.getPixels(), tile.rowBytes(),
+                         left, 0))
+      return false;
+    tile.setImmutable();
+    AddTile(TileKey(level, column, row), tile);
+    tiles->push_back(tile);
+  }
+  return true;
+}
+
+void TiledImage::AddTile(const TileKey& key, const SkBitmap& tile) {
+  size_t size = tile.getSize();
+  if (size > cache_size_)
+    return;
+
+  while (cached_bytes_ + size > cache_size_ && !tiles_.empty()) {
+    auto oldest = tiles_.rbegin();
+    cached_bytes_ -= oldest->second.getSize();
+    tiles_.Erase(oldest);
+  }
+  tiles_.Put(key, tile);
+  cached_bytes_ += size;
+}
+
+}  // namespace atom
@@ -0,0 +1,86 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_API_TILED_IMAGE_H_
+#define ATOM_COMMON_API_TILED_IMAGE_H_
+
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "base/containers/mru_cache.h"
+#include "base/macros.h"
+#include "skia/ext/image_operations.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkRefCnt.h"
+#include "ui/gfx/geometry/rect.h"
+#include "ui/gfx/geometry/size.h"
+
+class SkCodec;
+class SkData;
+
+namespace atom {
+
+// An encoded PNG or JPEG image that is decoded in tiles when drawn, keeping
+// at most |cache_size| bytes of decoded tiles around.
+//
+// Tiles are decoded row by row in one pass per draw, so drawing the bottom of
+// an image still inflates the rows above it, but only the requested tiles are
+// ever stored. JPEG images are also decoded at 1/2, 1/4 and 1/8 scale when
+// drawn that small.
+class TiledImage {
+ public:
+  // Returns nullptr when |data| is not a PNG or JPEG image that can be
+  // decoded from top to bottom.
+  static std::unique_ptr<TiledImage> Create(const char* data,
+                                            size_t length,
+                                            size_t cache_size);
+  ~TiledImage();
+
+  // Draws |region| of the image scaled to the size of |bitmap| with |method|,
+  // |bitmap| must have pixels allocated. Scaled regions are put together at
+  // their decoding level first, so they need a bitmap of that size too.
+  bool Draw(const gfx::Rect& region,
+            skia::ImageOperations::ResizeMethod method,
+            SkBitmap* bitmap);
+
+  gfx::Size size() const { return level_sizes_[0]; }
+  bool is_opaque() const { return is_opaque_; }
+  size_t cached_bytes() const { return cached_bytes_; }
+
+ private:
+  // Scale level, column and row of a tile.
+  using TileKey = std::tuple<int, int, int>;
+
+  TiledImage(sk_sp<SkData> data,
+             std::unique_ptr<SkCodec> codec,
+             size_t cache_size);
+
+  // Returns the smallest scale level that is still at least |scale| times
+  // the original size.
+  int GetLevel(float scale_x, float scale_y) const;
+
+  // Decodes the tiles of row |row| in |columns| into |tiles| and the cache.
+  // |next_line| is the next line of the scanline decoder, or -1 when it has
+  // not been started yet.
+  bool DecodeTiles(int level, int row, const std::vector<int>& columns,
+                   int* next_line, std::vector<SkBitmap>* tiles);
+
+  void AddTile(const TileKey& key, const SkBitmap& tile);
+
+  sk_sp<SkData> data_;
+  std::unique_ptr<SkCodec> codec_;
+  std::vector<gfx::Size> level_sizes_;
+  bool is_opaque_;
+
+  base::MRUCache<TileKey, SkBitmap> tiles_;
+  size_t cache_size_;
+  size_t cached_bytes_;
+
+  DISALLOW_COPY_AND_ASSIGN(TiledImage);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_API_TILED_IMAGE_H_
@@ -0,0 +1,36 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/api/value_serializer.h"
+
+#include <stdlib.h>
+
+namespace atom {
+
+bool SerializeV8Value(v8::Isolate* isolate,
+                      v8::Local<v8::Value> value,
+                      std::vector<uint8_t>* payload) {
+  v8::ValueSerializer serializer(isolate);
+  serializer.WriteHeader();
+  if (!serializer.WriteValue(isolate->GetCurrentContext(), value)
+          .FromMaybe(false))
+    return false;
+
+  std::pair<uint8_t*, size_t> buffer = serializer.Release();
+  payload->assign(buffer.first, buffer.first + buffer.second);
+  // The serializer allocates with realloc when there is no delegate.
+  free(buffer.first);
+  return true;
+}
+
+v8::MaybeLocal<v8::Value> DeserializeV8Value(
+    v8::Isolate* isolate, const std::vector<uint8_t>& payload) {
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+  v8::ValueDeserializer deserializer(isolate, payload.data(), payload.size());
+  if (!deserializer.ReadHeader(context).FromMaybe(false))
+    return v8::MaybeLocal<v8::Value>();
+  return deserializer.ReadValue(context);
+}
+
+}  // namespace atom
@@ -0,0 +1,33 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_API_VALUE_SERIALIZER_H_
+#define ATOM_COMMON_API_VALUE_SERIALIZER_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "v8/include/v8.h"
+
+namespace atom {
+
+// Serializes |value| with the structured clone algorithm into |payload|.
+// Unlike converting to base::Value, Maps, Sets, Dates, RegExps, typed arrays
+// and cyclic references survive the round trip.
+//
+// Returns false with a pending exception in |isolate| when |value| can not be
+// cloned, e.g. it contains functions.
+bool SerializeV8Value(v8::Isolate* isolate,
+                      v8::Local<v8::Value> value,
+                      std::vector<uint8_t>* payload);
+
+// Rebuilds the value serialized by SerializeV8Value in the current context of
+// |isolate|.
+v8::MaybeLocal<v8::Value> DeserializeV8Value(
+    v8::Isolate* isolate, const std::vector<uint8_t>& payload);
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_API_VALUE_SERIALIZER_H_
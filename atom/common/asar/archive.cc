@@ -4,17 +4,25 @@
 
 #include "atom/common/asar/archive.h"
 
+#include <string.h>
+
+#include <algorithm>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "atom/common/asar/archive_index.h"
 #include "atom/common/asar/scoped_temporary_file.h"
 #include "base/files/file.h"
 #include "base/files/file_util.h"
+#include "base/files/memory_mapped_file.h"
 #include "base/json/json_reader.h"
 #include "base/logging.h"
 #include "base/pickle.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
 #include "base/values.h"
+#include "third_party/zlib/zlib.h"
 
 #if defined(OS_WIN)
 #include "atom/node/osfhandle.h"
@@ -109,9 +117,68 @@ bool FillFileInfoWithNode(Archive::FileInfo* info,
 
   node->GetBoolean("executable", &info->executable);
 
+  std::string compression;
+  if (node->GetString("compression", &compression)) {
+    int compressed_size;
+    if (compression != "deflate" ||
+        !node->GetInteger("compressedSize", &compressed_size))
+      return false;
+    info->compressed = true;
+    info->compressed_size = static_cast<uint32_t>(compressed_size);
+  }
+
+  return true;
+}
+
+bool FillFileInfoWithIndexNode(Archive::FileInfo* info,
+                               uint32_t header_size,
+                               const IndexNode* node) {
+  if (node->flags & (IndexNode::FLAG_DIRECTORY | IndexNode::FLAG_LINK))
+    return false;
+  info->size = node->size;
+
+  info->unpacked = (node->flags & IndexNode::FLAG_UNPACKED) != 0;
+  if (info->unpacked)
+    return true;
+
+  info->offset = node->offset + header_size;
+  info->executable = (node->flags & IndexNode::FLAG_EXECUTABLE) != 0;
+  info->compressed = (node->flags & IndexNode::FLAG_COMPRESSED) != 0;
+  if (info->compressed)
+    info->compressed_size = node->count;
   return true;
 }
 
+// Files closer than this are prefetched with one read.
+const uint64_t kPrefetchMaxGap = 64 * 1024;
+// Size of each read when prefetching.
+const int kPrefetchChunkSize = 1024 * 1024;
+
+// Lines written by ELECTRON_LOG_ASAR_READS are prefixed with "offset: ".
+base::StringPiece StripAccessLogPrefix(const base::StringPiece& line) {
+  size_t colon = line.find(": ");
+  if (colon == base::StringPiece::npos || colon == 0)
+    return line;
+  for (size_t i = 0; i < colon; ++i) {
+    if (line[i] < '0' || line[i] > '9')
+      return line;
+  }
+  return line.substr(colon + 2);
+}
+
+bool InflateData(const base::StringPiece& input,
+                 uint32_t size,
+                 std::string* output) {
+  output->resize(size);
+  uLongf output_size = size;
+  int result = uncompress(
+      reinterpret_cast<Bytef*>(size == 0 ? nullptr : &(*output)[0]),
+      &output_size,
+      reinterpret_cast<const Bytef*>(input.data()),
+      static_cast<uLong>(input.size()));
+  return result == Z_OK && output_size == size;
+}
+
 }  // namespace
 
 Archive::Archive(const base::FilePath& path)
@@ -164,8 +231,29 @@ bool Archive::Init() {
     return false;
   }
 
+  header_size_ = 8 + size;
+
+  base::File::Info file_info;
+  if (file_.GetInfo(&file_info))
+    last_modified_ = file_info.last_modified;
+
+  // Map the whole archive so file contents can be read without syscalls, the
+  // legacy format can still fall back to reading the file.
+  base::File file = file_.Duplicate();
+  mapped_file_.reset(new base::MemoryMappedFile);
+  if (!file.IsValid() || !mapped_file_->Initialize(std::move(file))) {
+    LOG(WARNING) << "Failed to map " << path_.value();
+    mapped_file_.reset();
+  }
+
+  char magic[sizeof(kIndexMagic)];
+  len = file_.Read(8, magic, sizeof(magic));
+  if (len == static_cast<int>(sizeof(magic)) &&
+      memcmp(magic, kIndexMagic, sizeof(magic)) == 0)
+    return InitIndex();
+
   buf.resize(size);
-  len = file_.ReadAtCurrentPos(buf.data(), buf.size());
+  len = file_.Read(8, buf.data(), buf.size());
   if (len != static_cast<int>(buf.size())) {
     PLOG(ERROR) << "Failed to read header from " << path_.value();
     return false;
@@ -186,12 +274,38 @@ bool Archive::Init() {
     return false;
   }
 
-  header_size_ = 8 + size;
   header_.reset(static_cast<base::DictionaryValue*>(value.release()));
   return true;
 }
 
+bool Archive::InitIndex() {
+  if (!mapped_file_ || mapped_file_->length() < header_size_) {
+    LOG(ERROR) << "Failed to map header from " << path_.value();
+    return false;
+  }
+
+  index_.reset(new ArchiveIndex);
+  if (!index_->Init(mapped_file_->data() + 8, header_size_ - 8)) {
+    LOG(ERROR) << "Failed to parse binary header from " << path_.value();
+    index_.reset();
+    return false;
+  }
+  return true;
+}
+
 bool Archive::GetFileInfo(const base::FilePath& path, FileInfo* info) {
+  if (index_) {
+    const IndexNode* node = index_->Lookup(path.AsUTF8Unsafe());
+    if (!node)
+      return false;
+
+    if (node->flags & IndexNode::FLAG_LINK)
+      return GetFileInfo(base::FilePath::FromUTF8Unsafe(
+          index_->GetLinkTarget(node).as_string()), info);
+
+    return FillFileInfoWithIndexNode(info, header_size_, node);
+  }
+
   if (!header_)
     return false;
 
@@ -207,6 +321,26 @@ bool Archive::GetFileInfo(const base::FilePath& path, FileInfo* info) {
 }
 
 bool Archive::Stat(const base::FilePath& path, Stats* stats) {
+  if (index_) {
+    const IndexNode* node = index_->Lookup(path.AsUTF8Unsafe());
+    if (!node)
+      return false;
+
+    if (node->flags & IndexNode::FLAG_LINK) {
+      stats->is_file = false;
+      stats->is_link = true;
+      return true;
+    }
+
+    if (node->flags & IndexNode::FLAG_DIRECTORY) {
+      stats->is_file = false;
+      stats->is_directory = true;
+      return true;
+    }
+
+    return FillFileInfoWithIndexNode(stats, header_size_, node);
+  }
+
   if (!header_)
     return false;
 
@@ -231,6 +365,18 @@ bool Archive::Stat(const base::FilePath& path, Stats* stats) {
 
 bool Archive::Readdir(const base::FilePath& path,
                       std::vector<base::FilePath>* list) {
+  if (index_) {
+    const IndexNode* node = index_->Lookup(path.AsUTF8Unsafe());
+    std::vector<const IndexNode*> children;
+    if (!node || !index_->GetChildren(node, &children))
+      return false;
+
+    for (const IndexNode* child : children)
+      list->push_back(base::FilePath::FromUTF8Unsafe(
+          index_->GetName(child).as_string()));
+    return true;
+  }
+
   if (!header_)
     return false;
 
@@ -251,6 +397,21 @@ bool Archive::Readdir(const base::FilePath& path,
 }
 
 bool Archive::Realpath(const base::FilePath& path, base::FilePath* realpath) {
+  if (index_) {
+    const IndexNode* node = index_->Lookup(path.AsUTF8Unsafe());
+    if (!node)
+      return false;
+
+    if (node->flags & IndexNode::FLAG_LINK) {
+      *realpath = base::FilePath::FromUTF8Unsafe(
+          index_->GetLinkTarget(node).as_string());
+      return true;
+    }
+
+    *realpath = path;
+    return true;
+  }
+
   if (!header_)
     return false;
 
@@ -268,7 +429,30 @@ bool Archive::Realpath(const base::FilePath& path, base::FilePath* realpath) {
   return true;
 }
 
+bool Archive::ReadFile(const FileInfo& info, std::string* contents) {
+  if (info.unpacked)
+    return false;
+
+  uint32_t size = info.compressed ? info.compressed_size : info.size;
+  base::StringPiece data;
+  std::string buffer;
+  if (!GetMappedData(info.offset, size, &data)) {
+    buffer.resize(size);
+    if (size > 0 && file_.Read(info.offset, &buffer[0], size) !=
+                        static_cast<int>(size))
+      return false;
+    data = buffer;
+  }
+
+  if (info.compressed)
+    return InflateData(data, info.size, contents);
+
+  data.CopyToString(contents);
+  return true;
+}
+
 bool Archive::CopyFileOut(const base::FilePath& path, base::FilePath* out) {
+  base::AutoLock auto_lock(external_files_lock_);
   auto it = external_files_.find(path.value());
   if (it != external_files_.end()) {
     *out = it->second->path();
@@ -286,8 +470,17 @@ bool Archive::CopyFileOut(const base::FilePath& path, base::FilePath* out) {
 
   std::unique_ptr<ScopedTemporaryFile> temp_file(new ScopedTemporaryFile);
   base::FilePath::StringType ext = path.Extension();
-  if (!temp_file->InitFromFile(&file_, ext, info.offset, info.size))
+  base::StringPiece data;
+  std::string contents;
+  if (info.compressed) {
+    if (!ReadFile(info, &contents) || !temp_file->InitFromData(ext, contents))
+      return false;
+  } else if (GetMappedData(info.offset, info.size, &data)) {
+    if (!temp_file->InitFromData(ext, data))
+      return false;
+  } else if (!temp_file->InitFromFile(&file_, ext, info.offset, info.size)) {
     return false;
+  }
 
 #if defined(OS_POSIX)
   if (info.executable) {
@@ -301,6 +494,66 @@ bool Archive::CopyFileOut(const base::FilePath& path, base::FilePath* out) {
   return true;
 }
 
+bool Archive::GetMappedData(uint64_t offset,
+                            uint64_t size,
+                            base::StringPiece* data) const {
+  if (!mapped_file_ || offset > mapped_file_->length() ||
+      size > mapped_file_->length() - offset)
+    return false;
+
+  *data = base::StringPiece(
+      reinterpret_cast<const char*>(mapped_file_->data() + offset), size);
+  return true;
+}
+
+void Archive::Prefetch() {
+  std::string manifest;
+  if (!base::ReadFileToString(
+          path_.AddExtension(FILE_PATH_LITERAL("prefetch")), &manifest))
+    return;
+
+  // Collect the ranges of listed files, in the order of the archive.
+  std::vector<std::pair<uint64_t, uint64_t>> ranges;
+  for (const base::StringPiece& line : base::SplitStringPiece(
+           manifest, "\n", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY)) {
+    FileInfo info;
+    base::FilePath path = base::FilePath::FromUTF8Unsafe(
+        StripAccessLogPrefix(line).as_string());
+    if (!GetFileInfo(path, &info) || info.unpacked)
+      continue;
+    uint64_t size = info.compressed ? info.compressed_size : info.size;
+    ranges.push_back(std::make_pair(info.offset, info.offset + size));
+  }
+  std::sort(ranges.begin(), ranges.end());
+
+  // Merge nearby ranges so the disk is read sequentially in large chunks.
+  std::vector<std::pair<uint64_t, uint64_t>> merged;
+  for (const auto& range : ranges) {
+    if (!merged.empty() &&
+        range.first <= merged.back().second + kPrefetchMaxGap)
+      merged.back().second = std::max(merged.back().second, range.second);
+    else
+      merged.push_back(range);
+  }
+
+  // Reading the data is enough to bring it into the OS page cache, where the
+  // later reads and page faults of the mapping will find it.
+  base::File file(path_, base::File::FLAG_OPEN | base::File::FLAG_READ |
+                         base::File::FLAG_SEQUENTIAL_SCAN);
+  if (!file.IsValid())
+    return;
+  std::vector<char> buf(kPrefetchChunkSize);
+  for (const auto& range : merged) {
+    for (uint64_t offset = range.first; offset < range.second;
+         offset += kPrefetchChunkSize) {
+      int size = static_cast<int>(
+          std::min<uint64_t>(kPrefetchChunkSize, range.second - offset));
+      if (file.Read(offset, buf.data(), size) != size)
+        return;
+    }
+  }
+}
+
 int Archive::GetFD() const {
   return fd_;
 }
@@ -6,29 +6,41 @@
 #define ATOM_COMMON_ASAR_ARCHIVE_H_
 
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "base/files/file.h"
 #include "base/files/file_path.h"
+#include "base/strings/string_piece.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
 
 namespace base {
 class DictionaryValue;
+class MemoryMappedFile;
 }
 
 namespace asar {
 
+class ArchiveIndex;
 class ScopedTemporaryFile;
 
 // This class represents an asar package, and provides methods to read
-// information from it.
+// information from it. It is immutable after Init() and can be shared between
+// threads.
 class Archive {
  public:
   struct FileInfo {
-    FileInfo() : unpacked(false), executable(false), size(0), offset(0) {}
+    FileInfo() : unpacked(false), executable(false), compressed(false),
+                 size(0), compressed_size(0), offset(0) {}
     bool unpacked;
     bool executable;
+    // When the file is compressed, the |compressed_size| bytes at |offset| is
+    // a zlib stream which inflates to |size| bytes.
+    bool compressed;
     uint32_t size;
+    uint32_t compressed_size;
     uint64_t offset;
   };
 
@@ -42,7 +54,8 @@ class Archive {
   explicit Archive(const base::FilePath& path);
   virtual ~Archive();
 
-  // Read and parse the header.
+  // Read and parse the header, the header can be either the legacy JSON
+  // format or the binary format described in archive_index.h.
   bool Init();
 
   // Get the info of a file.
@@ -57,24 +70,53 @@ class Archive {
   // Fs.realpath(path).
   bool Realpath(const base::FilePath& path, base::FilePath* realpath);
 
+  // Read the content of a packed file, decompressing it when necessary.
+  bool ReadFile(const FileInfo& info, std::string* contents);
+
   // Copy the file into a temporary file, and return the new path.
   // For unpacked file, this method will return its real path.
   bool CopyFileOut(const base::FilePath& path, base::FilePath* out);
 
+  // Returns |size| bytes at |offset| of the archive from its read-only memory
+  // mapping. The data is valid as long as the Archive is alive, and must never
+  // be written to.
+  bool GetMappedData(uint64_t offset,
+                     uint64_t size,
+                     base::StringPiece* data) const;
+
+  // Warm the OS page cache with the files listed in the access-order manifest
+  // next to the archive ("app.asar.prefetch"), one relative path per line.
+  // This does blocking IO and should be called on a background thread.
+  void Prefetch();
+
   // Returns the file's fd.
   int GetFD() const;
 
   base::FilePath path() const { return path_; }
+  // Modification time of the archive file when it was opened.
+  base::Time last_modified() const { return last_modified_; }
+  // Only available for archives with the legacy JSON header.
   base::DictionaryValue* header() const { return header_.get(); }
 
  private:
+  // Point the binary header into the mapped archive.
+  bool InitIndex();
+
   base::FilePath path_;
   base::File file_;
   int fd_;
   uint32_t header_size_;
+  base::Time last_modified_;
   std::unique_ptr<base::DictionaryValue> header_;
 
+  // Read-only mapping of the whole archive.
+  std::unique_ptr<base::MemoryMappedFile> mapped_file_;
+
+  // The binary header, points into |mapped_file_|.
+  std::unique_ptr<ArchiveIndex> index_;
+
   // Cached external temporary files.
+  base::Lock external_files_lock_;
   std::unordered_map<base::FilePath::StringType,
                      std::unique_ptr<ScopedTemporaryFile>> external_files_;
 
@@ -0,0 +1,181 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/asar/archive_index.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+namespace asar {
+
+namespace {
+
+#if defined(OS_WIN)
+const char kSeparators[] = "\\/";
+#else
+const char kSeparators[] = "/";
+#endif
+
+// Maximum number of links to follow when resolving a path.
+const int kMaxLinkDepth = 32;
+
+bool IsTableInBounds(uint32_t offset, uint32_t count, size_t entry_size,
+                     size_t size) {
+  return static_cast<uint64_t>(offset) +
+         static_cast<uint64_t>(count) * entry_size <= size;
+}
+
+}  // namespace
+
+ArchiveIndex::ArchiveIndex()
+    : header_(nullptr),
+      nodes_(nullptr),
+      paths_(nullptr),
+      strings_(nullptr) {
+}
+
+ArchiveIndex::~ArchiveIndex() {
+}
+
+// static
+bool ArchiveIndex::IsIndex(const uint8_t* data, size_t size) {
+  return size >= sizeof(IndexHeader) &&
+         memcmp(data, kIndexMagic, sizeof(kIndexMagic)) == 0;
+}
+
+bool ArchiveIndex::Init(const uint8_t* data, size_t size) {
+  if (!IsIndex(data, size))
+    return false;
+
+  const IndexHeader* header = reinterpret_cast<const IndexHeader*>(data);
+  if (header->version == 0 || header->version > kIndexVersion ||
+      header->node_count == 0 ||
+      header->nodes_offset % alignof(IndexNode) != 0 ||
+      header->paths_offset % alignof(IndexPath) != 0 ||
+      !IsTableInBounds(header->nodes_offset, header->node_count,
+                       sizeof(IndexNode), size) ||
+      !IsTableInBounds(header->paths_offset, header->path_count,
+                       sizeof(IndexPath), size) ||
+      !IsTableInBounds(header->strings_offset, header->strings_size, 1, size))
+    return false;
+
+  header_ = header;
+  nodes_ = reinterpret_cast<const IndexNode*>(data + header->nodes_offset);
+  paths_ = reinterpret_cast<const IndexPath*>(data + header->paths_offset);
+  strings_ = reinterpret_cast<const char*>(data + header->strings_offset);
+  return (root()->flags & IndexNode::FLAG_DIRECTORY) != 0;
+}
+
+const IndexNode* ArchiveIndex::Lookup(base::StringPiece path) const {
+  if (path.empty())
+    return root();
+
+  // Most lookups do not go through linked directories, so try the path table
+  // first and only walk the tree when it misses.
+  const IndexNode* node = FindPath(path);
+  if (node)
+    return node;
+  return Walk(path, 0);
+}
+
+bool ArchiveIndex::GetChildren(const IndexNode* node,
+                               std::vector<const IndexNode*>* children) const {
+  const IndexNode* dir = ResolveDirectory(node, 0);
+  if (!dir)
+    return false;
+
+  children->reserve(children->size() + dir->count);
+  for (uint32_t i = 0; i < dir->count; ++i)
+    children->push_back(nodes_ + dir->first + i);
+  return true;
+}
+
+base::StringPiece ArchiveIndex::GetName(const IndexNode* node) const {
+  return GetString(node->name, node->name_size);
+}
+
+base::StringPiece ArchiveIndex::GetLinkTarget(const IndexNode* node) const {
+  if (!(node->flags & IndexNode::FLAG_LINK))
+    return base::StringPiece();
+  return GetString(node->first, node->count);
+}
+
+const IndexNode* ArchiveIndex::FindPath(base::StringPiece path) const {
+  const IndexPath* begin = paths_;
+  const IndexPath* end = paths_ + header_->path_count;
+  const IndexPath* it = std::lower_bound(
+      begin, end, path,
+      [this](const IndexPath& entry, base::StringPiece value) {
+        return GetString(entry.path, entry.path_size) < value;
+      });
+  if (it == end || GetString(it->path, it->path_size) != path ||
+      it->node >= header_->node_count)
+    return nullptr;
+  return nodes_ + it->node;
+}
+
+const IndexNode* ArchiveIndex::FindChild(const IndexNode* dir,
+                                         base::StringPiece name) const {
+  const IndexNode* begin = nodes_ + dir->first;
+  const IndexNode* end = begin + dir->count;
+  const IndexNode* it = std::lower_bound(
+      begin, end, name,
+      [this](const IndexNode& node, base::StringPiece value) {
+        return GetName(&node) < value;
+      });
+  if (it == end || GetName(it) != name)
+    return nullptr;
+  return it;
+}
+
+const IndexNode* ArchiveIndex::Walk(base::StringPiece path, int depth) const {
+  if (depth > kMaxLinkDepth)
+    return nullptr;
+
+  const IndexNode* node = root();
+  size_t start = 0;
+  while (true) {
+    size_t end = path.find_first_of(kSeparators, start);
+    base::StringPiece name = path.substr(
+        start, end == base::StringPiece::npos ? end : end - start);
+    if (name.empty()) {
+      node = root();
+    } else {
+      const IndexNode* dir = ResolveDirectory(node, depth);
+      if (!dir)
+        return nullptr;
+      node = FindChild(dir, name);
+      if (!node)
+        return nullptr;
+    }
+
+    if (end == base::StringPiece::npos)
+      return node;
+    start = end + 1;
+  }
+}
+
+const IndexNode* ArchiveIndex::ResolveDirectory(const IndexNode* node,
+                                                int depth) const {
+  if (node->flags & IndexNode::FLAG_LINK) {
+    node = Walk(GetLinkTarget(node), depth + 1);
+    if (!node)
+      return nullptr;
+  }
+
+  if (!(node->flags & IndexNode::FLAG_DIRECTORY) ||
+      static_cast<uint64_t>(node->first) + node->count > header_->node_count)
+    return nullptr;
+  return node;
+}
+
+base::StringPiece ArchiveIndex::GetString(uint32_t offset,
+                                          uint32_t size) const {
+  if (static_cast<uint64_t>(offset) + size > header_->strings_size)
+    return base::StringPiece();
+  return base::StringPiece(strings_ + offset, size);
+}
+
+}  // namespace asar
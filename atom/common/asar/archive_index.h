@@ -0,0 +1,131 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_ASAR_ARCHIVE_INDEX_H_
+#define ATOM_COMMON_ASAR_ARCHIVE_INDEX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+
+namespace asar {
+
+// The binary header of an asar archive.
+//
+// An archive starts with a pickled uint32 holding the header size, same with
+// the legacy JSON format. For the binary format the header is not a pickle but
+// the following layout, which is used in place without any parsing:
+//
+//   IndexHeader
+//   IndexNode[node_count]      sorted so that the children of every directory
+//                              are contiguous and ordered by name, node 0 is
+//                              the root directory
+//   IndexPath[path_count]      full relative paths ("/" separated) of every
+//                              node except root, ordered bytewise
+//   char strings[strings_size] names, full paths and link targets
+//
+// All integers are little-endian, and all offsets in IndexHeader are relative
+// to the beginning of IndexHeader.
+const char kIndexMagic[8] = {'A', 'S', 'A', 'R', 'I', 'D', 'X', '\0'};
+// Version 2 adds compressed files.
+const uint32_t kIndexVersion = 2;
+
+struct IndexHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t node_count;
+  uint32_t nodes_offset;
+  uint32_t path_count;
+  uint32_t paths_offset;
+  uint32_t strings_offset;
+  uint32_t strings_size;
+  uint32_t reserved;
+};
+static_assert(sizeof(IndexHeader) == 40, "IndexHeader must be packed");
+
+struct IndexNode {
+  enum Flags : uint32_t {
+    FLAG_DIRECTORY  = 1 << 0,
+    FLAG_LINK       = 1 << 1,
+    FLAG_UNPACKED   = 1 << 2,
+    FLAG_EXECUTABLE = 1 << 3,
+    FLAG_COMPRESSED = 1 << 4,
+  };
+
+  // Offset of file content, relative to the end of header.
+  uint64_t offset;
+  uint32_t size;
+  uint32_t flags;
+  // Name of the node in the string table.
+  uint32_t name;
+  uint32_t name_size;
+  // For directories: the range of children in the node table.
+  // For links: the target path in the string table.
+  // For compressed files: |count| is the size of the zlib stream at |offset|,
+  // while |size| is the size after inflating.
+  uint32_t first;
+  uint32_t count;
+};
+static_assert(sizeof(IndexNode) == 32, "IndexNode must be packed");
+
+struct IndexPath {
+  uint32_t path;
+  uint32_t path_size;
+  uint32_t node;
+};
+static_assert(sizeof(IndexPath) == 12, "IndexPath must be packed");
+
+// Read-only view of a binary header, the memory is not owned.
+class ArchiveIndex {
+ public:
+  ArchiveIndex();
+  ~ArchiveIndex();
+
+  // Returns whether |data| starts with the binary header magic.
+  static bool IsIndex(const uint8_t* data, size_t size);
+
+  // Points the index to |data|, and validates the tables' bounds.
+  bool Init(const uint8_t* data, size_t size);
+
+  // Finds the node of |path|, following links of parent directories.
+  const IndexNode* Lookup(base::StringPiece path) const;
+
+  // Returns the children of directory |node|.
+  bool GetChildren(const IndexNode* node,
+                   std::vector<const IndexNode*>* children) const;
+
+  base::StringPiece GetName(const IndexNode* node) const;
+  base::StringPiece GetLinkTarget(const IndexNode* node) const;
+
+  const IndexNode* root() const { return nodes_; }
+  uint32_t node_count() const { return header_->node_count; }
+
+ private:
+  // Binary search in the sorted path table.
+  const IndexNode* FindPath(base::StringPiece path) const;
+  // Binary search in the children of |dir|.
+  const IndexNode* FindChild(const IndexNode* dir,
+                             base::StringPiece name) const;
+  // Walks |path| component by component, resolving linked directories.
+  const IndexNode* Walk(base::StringPiece path, int depth) const;
+  // Follows |node| if it is a link to a directory.
+  const IndexNode* ResolveDirectory(const IndexNode* node, int depth) const;
+
+  base::StringPiece GetString(uint32_t offset, uint32_t size) const;
+
+  const IndexHeader* header_;
+  const IndexNode* nodes_;
+  const IndexPath* paths_;
+  const char* strings_;
+
+  DISALLOW_COPY_AND_ASSIGN(ArchiveIndex);
+};
+
+}  // namespace asar
+
+#endif  // ATOM_COMMON_ASAR_ARCHIVE_INDEX_H_
@@ -6,43 +6,99 @@
 
 #include <map>
 #include <string>
+#include <utility>
 
 #include "atom/common/asar/archive.h"
+#include "base/bind.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
 #include "base/lazy_instance.h"
-#include "base/stl_util.h"
-#include "base/threading/thread_local.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/worker_pool.h"
 
 namespace asar {
 
 namespace {
 
-// The global instance of ArchiveMap, will be destroyed on exit.
-typedef std::map<base::FilePath, std::shared_ptr<Archive>> ArchiveMap;
-base::LazyInstance<base::ThreadLocalPointer<ArchiveMap>>::Leaky
-    g_archive_map_tls = LAZY_INSTANCE_INITIALIZER;
+void PrefetchArchive(std::shared_ptr<Archive> archive) {
+  archive->Prefetch();
+}
+
+// Archives are immutable once initialized, so one instance of each archive is
+// shared by all threads of the process.
+class ArchiveCache {
+ public:
+  ArchiveCache() : hits_(0), misses_(0) {}
+
+  std::shared_ptr<Archive> Get(const base::FilePath& path) {
+    {
+      base::AutoLock auto_lock(lock_);
+      auto it = archives_.find(path);
+      if (it != archives_.end()) {
+        ++hits_;
+        return it->second;
+      }
+      ++misses_;
+    }
+
+    // Read the header without holding the lock, if another thread has done
+    // the same in the meantime its instance wins.
+    std::shared_ptr<Archive> archive(new Archive(path));
+    if (!archive->Init())
+      return nullptr;
+
+    {
+      base::AutoLock auto_lock(lock_);
+      auto result = archives_.insert(std::make_pair(path, archive));
+      if (!result.second)
+        return result.first->second;
+    }
+
+    // Warm up the files listed in the archive's access-order manifest.
+    base::WorkerPool::PostTask(
+        FROM_HERE, base::Bind(&PrefetchArchive, archive), true);
+    return archive;
+  }
+
+  void Clear() {
+    base::AutoLock auto_lock(lock_);
+    archives_.clear();
+  }
+
+  void GetStats(ArchiveCacheStats* stats) {
+    base::AutoLock auto_lock(lock_);
+    stats->archives = archives_.size();
+    stats->hits = hits_;
+    stats->misses = misses_;
+  }
+
+ private:
+  base::Lock lock_;
+  std::map<base::FilePath, std::shared_ptr<Archive>> archives_;
+  uint64_t hits_;
+  uint64_t misses_;
+
+  DISALLOW_COPY_AND_ASSIGN(ArchiveCache);
+};
+
+// The global instance of ArchiveCache, will be destroyed on exit.
+base::LazyInstance<ArchiveCache>::Leaky g_archive_cache =
+    LAZY_INSTANCE_INITIALIZER;
 
 const base::FilePath::CharType kAsarExtension[] = FILE_PATH_LITERAL(".asar");
 
 }  // namespace
 
 std::shared_ptr<Archive> GetOrCreateAsarArchive(const base::FilePath& path) {
-  if (!g_archive_map_tls.Pointer()->Get())
-    g_archive_map_tls.Pointer()->Set(new ArchiveMap);
-  ArchiveMap& archive_map = *g_archive_map_tls.Pointer()->Get();
-  if (!ContainsKey(archive_map, path)) {
-    std::shared_ptr<Archive> archive(new Archive(path));
-    if (!archive->Init())
-      return nullptr;
-    archive_map[path] = archive;
-  }
-  return archive_map[path];
+  return g_archive_cache.Get().Get(path);
 }
 
 void ClearArchives() {
-  if (g_archive_map_tls.Pointer()->Get())
-    delete g_archive_map_tls.Pointer()->Get();
+  g_archive_cache.Get().Clear();
+}
+
+void GetArchiveCacheStats(ArchiveCacheStats* stats) {
+  g_archive_cache.Get().GetStats(stats);
 }
 
 bool GetAsarArchivePath(const base::FilePath& full_path,
@@ -87,13 +143,7 @@ bool ReadFileToString(const base::FilePath& path, std::string* contents) {
     return base::ReadFileToString(real_path, contents);
   }
 
-  base::File src(asar_path, base::File::FLAG_OPEN | base::File::FLAG_READ);
-  if (!src.IsValid())
-    return false;
-
-  contents->resize(info.size);
-  return static_cast<int>(info.size) == src.Read(
-      info.offset, const_cast<char*>(contents->data()), contents->size());
+  return archive->ReadFile(info, contents);
 }
 
 }  // namespace asar
@@ -5,6 +5,9 @@
 #ifndef ATOM_COMMON_ASAR_ASAR_UTIL_H_
 #define ATOM_COMMON_ASAR_ASAR_UTIL_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <memory>
 #include <string>
 
@@ -16,12 +19,22 @@ namespace asar {
 
 class Archive;
 
-// Gets or creates a new Archive from the path.
+struct ArchiveCacheStats {
+  size_t archives;
+  uint64_t hits;
+  uint64_t misses;
+};
+
+// Gets or creates a new Archive from the path, the Archive is shared by all
+// threads of the process.
 std::shared_ptr<Archive> GetOrCreateAsarArchive(const base::FilePath& path);
 
 // Destroy cached Archive objects.
 void ClearArchives();
 
+// Returns the statistics of the process-wide Archive cache.
+void GetArchiveCacheStats(ArchiveCacheStats* stats);
+
 // Separates the path to Archive out.
 bool GetAsarArchivePath(const base::FilePath& full_path,
                         base::FilePath* asar_path,
@@ -55,20 +55,25 @@ bool ScopedTemporaryFile::InitFromFile(base::File* src,
   if (!src->IsValid())
     return false;
 
-  if (!Init(ext))
-    return false;
-
   std::vector<char> buf(size);
   int len = src->Read(offset, buf.data(), buf.size());
   if (len != static_cast<int>(size))
     return false;
 
+  return InitFromData(ext, base::StringPiece(buf.data(), buf.size()));
+}
+
+bool ScopedTemporaryFile::InitFromData(const base::FilePath::StringType& ext,
+                                       const base::StringPiece& data) {
+  if (!Init(ext))
+    return false;
+
   base::File dest(path_, base::File::FLAG_OPEN | base::File::FLAG_WRITE);
   if (!dest.IsValid())
     return false;
 
-  return dest.WriteAtCurrentPos(buf.data(), buf.size()) ==
-      static_cast<int>(size);
+  return dest.WriteAtCurrentPos(data.data(), data.size()) ==
+      static_cast<int>(data.size());
 }
 
 }  // namespace asar
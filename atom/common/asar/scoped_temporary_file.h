@@ -6,6 +6,7 @@
 #define ATOM_COMMON_ASAR_SCOPED_TEMPORARY_FILE_H_
 
 #include "base/files/file_path.h"
+#include "base/strings/string_piece.h"
 
 namespace base {
 class File;
@@ -30,6 +31,10 @@ class ScopedTemporaryFile {
                     const base::FilePath::StringType& ext,
                     uint64_t offset, uint64_t size);
 
+  // Init an temporary file and fill it with |data|.
+  bool InitFromData(const base::FilePath::StringType& ext,
+                    const base::StringPiece& data);
+
   base::FilePath path() const { return path_; }
 
  private:
@@ -45,6 +45,10 @@ bool CertFromData(const std::string& data,
   return true;
 }
 
+void ReleaseUploadBytes(char* data, void* hint) {
+  static_cast<base::RefCountedBytes*>(hint)->Release();
+}
+
 }  // namespace
 
 // static
@@ -165,17 +169,92 @@ v8::Local<v8::Value> Converter<net::HttpResponseHeaders*>::ToV8(
   return ConvertToV8(isolate, response_headers);
 }
 
+// static
+v8::Local<v8::Value> Converter<const atom::UploadData*>::ToV8(
+    v8::Isolate* isolate,
+    const atom::UploadData* val) {
+  const auto& elements = val->elements();
+  v8::Local<v8::Array> result = v8::Array::New(isolate, elements.size());
+  for (size_t i = 0; i < elements.size(); ++i) {
+    const atom::UploadData::Element& element = elements[i];
+    mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
+    if (element.bytes && element.bytes->size() == 0) {
+      dict.Set("bytes", node::Buffer::New(isolate, 0).ToLocalChecked());
+    } else if (element.bytes) {
+      // The buffer keeps a reference to the bytes instead of copying them.
+      element.bytes->AddRef();
+      dict.Set("bytes", node::Buffer::New(
+          isolate, reinterpret_cast<char*>(element.bytes->front()),
+          element.bytes->size(), &ReleaseUploadBytes,
+          element.bytes.get()).ToLocalChecked());
+    } else if (!element.file.empty()) {
+      dict.Set("file", element.file);
+    } else {
+      dict.Set("blobUUID", element.blob_uuid);
+    }
+    result->Set(static_cast<uint32_t>(i), dict.GetHandle());
+  }
+  return result;
+}
+
 }  // namespace mate
 
 namespace atom {
 
-void FillRequestDetails(base::DictionaryValue* details,
-                        const net::URLRequest* request) {
+UploadData::Element::Element() {
+}
+
+UploadData::Element::Element(const Element& other) = default;
+
+UploadData::Element::~Element() {
+}
+
+UploadData::UploadData() {
+}
+
+UploadData::~UploadData() {
+}
+
+// static
+scoped_refptr<UploadData> UploadData::Create(const net::URLRequest* request) {
+  const net::UploadDataStream* upload_data = request->get_upload();
+  if (!upload_data)
+    return nullptr;
+
+  scoped_refptr<UploadData> result(new UploadData);
+  for (const auto& reader : *upload_data->GetElementReaders()) {
+    Element element;
+    if (reader->AsBytesReader()) {
+      const net::UploadBytesElementReader* bytes_reader =
+          reader->AsBytesReader();
+      const unsigned char* bytes =
+          reinterpret_cast<const unsigned char*>(bytes_reader->bytes());
+      element.bytes = new base::RefCountedBytes(bytes, bytes_reader->length());
+    } else if (reader->AsFileReader()) {
+      element.file = reader->AsFileReader()->path().AsUTF8Unsafe();
+    } else {
+      element.blob_uuid =
+          static_cast<storage::UploadBlobElementReader*>(reader.get())->uuid();
+    }
+    result->elements_.push_back(element);
+  }
+  if (result->elements_.empty())
+    return nullptr;
+  return result;
+}
+
+void FillRequestInfo(base::DictionaryValue* details,
+                     const net::URLRequest* request) {
   details->SetString("method", request->method());
   std::string url;
   if (!request->url_chain().empty()) url = request->url().spec();
   details->SetStringWithoutPathExpansion("url", url);
   details->SetString("referrer", request->referrer());
+}
+
+void FillRequestDetails(base::DictionaryValue* details,
+                        const net::URLRequest* request) {
+  FillRequestInfo(details, request);
   std::unique_ptr<base::ListValue> list(new base::ListValue);
   GetUploadData(list.get(), request);
   if (!list->empty())
@@ -5,7 +5,12 @@
 #ifndef ATOM_COMMON_NATIVE_MATE_CONVERTERS_NET_CONVERTER_H_
 #define ATOM_COMMON_NATIVE_MATE_CONVERTERS_NET_CONVERTER_H_
 
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
 #include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
 #include "native_mate/converter.h"
 
 namespace base {
@@ -21,6 +26,10 @@ class HttpResponseHeaders;
 struct CertPrincipal;
 }
 
+namespace atom {
+class UploadData;
+}
+
 namespace mate {
 
 template<>
@@ -51,10 +60,52 @@ struct Converter<net::HttpResponseHeaders*> {
                                    net::HttpResponseHeaders* headers);
 };
 
+template<>
+struct Converter<const atom::UploadData*> {
+  static v8::Local<v8::Value> ToV8(v8::Isolate* isolate,
+                                   const atom::UploadData* val);
+};
+
 }  // namespace mate
 
 namespace atom {
 
+// The upload data of a request. The bytes are copied from the request once
+// and then shared by reference, including with the buffers of JavaScript.
+class UploadData : public base::RefCountedThreadSafe<UploadData> {
+ public:
+  struct Element {
+    Element();
+    Element(const Element& other);
+    ~Element();
+
+    // Only one of them is set.
+    scoped_refptr<base::RefCountedBytes> bytes;
+    std::string file;
+    std::string blob_uuid;
+  };
+
+  // Returns null when |request| has no upload data.
+  static scoped_refptr<UploadData> Create(const net::URLRequest* request);
+
+  const std::vector<Element>& elements() const { return elements_; }
+
+ private:
+  friend class base::RefCountedThreadSafe<UploadData>;
+
+  UploadData();
+  ~UploadData();
+
+  std::vector<Element> elements_;
+
+  DISALLOW_COPY_AND_ASSIGN(UploadData);
+};
+
+// Fills the method, url and referrer of |request|.
+void FillRequestInfo(base::DictionaryValue* details,
+                     const net::URLRequest* request);
+
+// Fills the request info and a copy of the upload data.
 void FillRequestDetails(base::DictionaryValue* details,
                         const net::URLRequest* request);
 
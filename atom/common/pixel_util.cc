@@ -0,0 +1,126 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/pixel_util.h"
+
+#include "third_party/libyuv/include/libyuv/convert_argb.h"
+#include "third_party/libyuv/include/libyuv/convert_from_argb.h"
+#include "third_party/libyuv/include/libyuv/planar_functions.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+
+namespace atom {
+
+// libyuv's ARGB is BGRA in memory, and ABGR is RGBA.
+static_assert(kN32_SkColorType == kBGRA_8888_SkColorType,
+              "N32 bitmaps are expected to be BGRA");
+
+bool GetPixelFormatFromString(const std::string& name, PixelFormat* format) {
+  if (name == "bgra")
+    *format = PixelFormat::BGRA;
+  else if (name == "rgba")
+    *format = PixelFormat::RGBA;
+  else if (name == "gray")
+    *format = PixelFormat::GRAY;
+  else if (name == "rgb565")
+    *format = PixelFormat::RGB565;
+  else
+    return false;
+  return true;
+}
+
+int GetBytesPerPixel(PixelFormat format) {
+  switch (format) {
+    case PixelFormat::GRAY:
+      return 1;
+    case PixelFormat::RGB565:
+      return 2;
+    default:
+      return 4;
+  }
+}
+
+bool ConvertFromN32(const SkBitmap& bitmap,
+                    PixelFormat format,
+                    bool premultiplied,
+                    uint8_t* dst,
+                    int dst_stride) {
+  SkAutoLockPixels bitmap_lock(bitmap);
+  if (bitmap.colorType() != kN32_SkColorType || !bitmap.getPixels())
+    return false;
+
+  const uint8_t* src = static_cast<const uint8_t*>(bitmap.getPixels());
+  int src_stride = static_cast<int>(bitmap.rowBytes());
+  int width = bitmap.width();
+  int height = bitmap.height();
+  // Opaque colors are the same either way.
+  bool unpremultiply =
+      !premultiplied && bitmap.alphaType() == kPremul_SkAlphaType;
+
+  switch (format) {
+    case PixelFormat::BGRA:
+      if (unpremultiply)
+        return libyuv::ARGBUnattenuate(src, src_stride, dst, dst_stride,
+                                       width, height) == 0;
+      return libyuv::ARGBCopy(src, src_stride, dst, dst_stride,
+                              width, height) == 0;
+    case PixelFormat::RGBA:
+      if (unpremultiply) {
+        // Unpremultiply into |dst| and swizzle it in place.
+        if (libyuv::ARGBUnattenuate(src, src_stride, dst, dst_stride,
+                                    width, height) != 0)
+          return false;
+        src = dst;
+        src_stride = dst_stride;
+      }
+      return libyuv::ARGBToABGR(src, src_stride, dst, dst_stride,
+                                width, height) == 0;
+    case PixelFormat::GRAY:
+      return libyuv::ARGBToJ400(src, src_stride, dst, dst_stride,
+                                width, height) == 0;
+    case PixelFormat::RGB565:
+      return libyuv::ARGBToRGB565(src, src_stride, dst, dst_stride,
+                                  width, height) == 0;
+  }
+  return false;
+}
+
+bool ConvertToN32(const uint8_t* src,
+                  int src_stride,
+                  PixelFormat format,
+                  bool premultiplied,
+                  int width,
+                  int height,
+                  SkBitmap* bitmap) {
+  bool is_opaque =
+      format == PixelFormat::GRAY || format == PixelFormat::RGB565;
+  if (!bitmap->tryAllocN32Pixels(width, height, is_opaque))
+    return false;
+
+  uint8_t* dst = static_cast<uint8_t*>(bitmap->getPixels());
+  int dst_stride = static_cast<int>(bitmap->rowBytes());
+  switch (format) {
+    case PixelFormat::BGRA:
+      if (!premultiplied)
+        return libyuv::ARGBAttenuate(src, src_stride, dst, dst_stride,
+                                     width, height) == 0;
+      return libyuv::ARGBCopy(src, src_stride, dst, dst_stride,
+                              width, height) == 0;
+    case PixelFormat::RGBA:
+      if (libyuv::ABGRToARGB(src, src_stride, dst, dst_stride,
+                             width, height) != 0)
+        return false;
+      return premultiplied ||
+             libyuv::ARGBAttenuate(dst, dst_stride, dst, dst_stride,
+                                   width, height) == 0;
+    case PixelFormat::GRAY:
+      return libyuv::J400ToARGB(src, src_stride, dst, dst_stride,
+                                width, height) == 0;
+    case PixelFormat::RGB565:
+      return libyuv::RGB565ToARGB(src, src_stride, dst, dst_stride,
+                                  width, height) == 0;
+  }
+  return false;
+}
+
+}  // namespace atom
@@ -0,0 +1,54 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_PIXEL_UTIL_H_
+#define ATOM_COMMON_PIXEL_UTIL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+class SkBitmap;
+
+namespace atom {
+
+// Layouts of raw pixels exchanged with JavaScript, rows are tightly packed.
+enum class PixelFormat {
+  BGRA,    // Same with Skia's N32 bitmaps.
+  RGBA,
+  GRAY,    // 8-bit luma, composited on black.
+  RGB565,  // 16-bit little endian, composited on black.
+};
+
+// Parse format names like "bgra" or "rgb565".
+bool GetPixelFormatFromString(const std::string& name, PixelFormat* format);
+
+int GetBytesPerPixel(PixelFormat format);
+
+// Converts the N32 |bitmap| into |dst|, which must hold the bitmap's height
+// rows of |dst_stride| bytes. Colors are unpremultiplied when |premultiplied|
+// is false, which only matters to the BGRA and RGBA formats.
+//
+// The conversions are done by libyuv, which picks SSE2, AVX2 or NEON row
+// functions from the running CPU.
+bool ConvertFromN32(const SkBitmap& bitmap,
+                    PixelFormat format,
+                    bool premultiplied,
+                    uint8_t* dst,
+                    int dst_stride);
+
+// Creates a premultiplied N32 bitmap from |width| x |height| pixels of
+// |format| in |src|.
+bool ConvertToN32(const uint8_t* src,
+                  int src_stride,
+                  PixelFormat format,
+                  bool premultiplied,
+                  int width,
+                  int height,
+                  SkBitmap* bitmap);
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_PIXEL_UTIL_H_
@@ -3,10 +3,19 @@
 // found in the LICENSE file.
 
 #include "atom/renderer/api/atom_api_renderer_ipc.h"
+
+#include <limits>
+#include <memory>
+#include <vector>
+
 #include "atom/common/api/api_messages.h"
+#include "atom/common/api/value_serializer.h"
 #include "atom/common/native_mate_converters/string16_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
 #include "atom/common/node_includes.h"
+#include "base/memory/shared_memory.h"
+#include "content/public/renderer/render_frame.h"
+#include "content/public/renderer/render_thread.h"
 #include "content/public/renderer/render_view.h"
 #include "native_mate/dictionary.h"
 #include "third_party/WebKit/public/web/WebLocalFrame.h"
@@ -46,6 +55,80 @@ void Send(mate::Arguments* args,
     args->ThrowError("Unable to send AtomViewHostMsg_Message");
 }
 
+void SendSerialized(mate::Arguments* args,
+                    const base::string16& channel,
+                    v8::Local<v8::Value> arguments) {
+  RenderView* render_view = GetCurrentRenderView();
+  if (render_view == nullptr)
+    return;
+
+  // The DataCloneError thrown by the serializer is left to the caller.
+  std::vector<uint8_t> payload;
+  if (!SerializeV8Value(args->isolate(), arguments, &payload))
+    return;
+
+  bool success = render_view->Send(new AtomViewHostMsg_Message_Serialized(
+      render_view->GetRoutingID(), channel, payload));
+
+  if (!success)
+    args->ThrowError("Unable to send AtomViewHostMsg_Message_Serialized");
+}
+
+void SendSharedMemory(mate::Arguments* args,
+                      const base::string16& channel,
+                      v8::Local<v8::Value> buffer) {
+  if (!buffer->IsArrayBufferView()) {
+    args->ThrowError("Buffer must be an ArrayBufferView");
+    return;
+  }
+
+  auto view = v8::Local<v8::ArrayBufferView>::Cast(buffer);
+  size_t size = view->ByteLength();
+  if (size == 0 || size > std::numeric_limits<uint32_t>::max()) {
+    args->ThrowError("Invalid buffer size");
+    return;
+  }
+
+  RenderView* render_view = GetCurrentRenderView();
+  if (render_view == nullptr)
+    return;
+
+  // Allocate through the browser process, renderers can not create shared
+  // memory by themselves in sandbox.
+  std::unique_ptr<base::SharedMemory> shared_memory =
+      content::RenderThread::Get()->HostAllocateSharedMemoryBuffer(size);
+  if (!shared_memory || !shared_memory->Map(size)) {
+    args->ThrowError("Unable to allocate shared memory");
+    return;
+  }
+  view->CopyContents(shared_memory->memory(), size);
+
+  bool success = render_view->Send(new AtomViewHostMsg_Message_SharedMemory(
+      render_view->GetRoutingID(), channel,
+      base::SharedMemory::DuplicateHandle(shared_memory->handle()),
+      static_cast<uint32_t>(size)));
+
+  if (!success)
+    args->ThrowError("Unable to send AtomViewHostMsg_Message_SharedMemory");
+}
+
+bool SendInvoke(mate::Arguments* args, v8::Local<v8::Value> arguments) {
+  WebLocalFrame* frame = WebLocalFrame::frameForCurrentContext();
+  content::RenderFrame* render_frame =
+      frame ? content::RenderFrame::FromWebFrame(frame) : nullptr;
+  if (render_frame == nullptr)
+    return false;
+
+  // The DataCloneError thrown by the serializer is left to the caller.
+  std::vector<uint8_t> payload;
+  if (!SerializeV8Value(args->isolate(), arguments, &payload))
+    return false;
+
+  RenderView* render_view = render_frame->GetRenderView();
+  return render_view->Send(new AtomViewHostMsg_Invoke(
+      render_view->GetRoutingID(), render_frame->GetRoutingID(), payload));
+}
+
 base::string16 SendSync(mate::Arguments* args,
                         const base::string16& channel,
                         const base::ListValue& arguments) {
@@ -69,6 +152,9 @@ void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
                 v8::Local<v8::Context> context, void* priv) {
   mate::Dictionary dict(context->GetIsolate(), exports);
   dict.SetMethod("send", &Send);
+  dict.SetMethod("sendSerialized", &SendSerialized);
+  dict.SetMethod("sendSharedMemory", &SendSharedMemory);
+  dict.SetMethod("sendInvoke", &SendInvoke);
   dict.SetMethod("sendSync", &SendSync);
 }
 
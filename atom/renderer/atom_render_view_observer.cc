@@ -4,6 +4,7 @@
 
 #include "atom/renderer/atom_render_view_observer.h"
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -12,12 +13,15 @@
 
 #include "atom/common/api/api_messages.h"
 #include "atom/common/api/event_emitter_caller.h"
+#include "atom/common/api/value_serializer.h"
 #include "atom/common/native_mate_converters/value_converter.h"
 #include "atom/common/node_includes.h"
 #include "atom/renderer/atom_renderer_client.h"
 #include "base/command_line.h"
+#include "base/memory/shared_memory.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/trace_event/trace_event.h"
+#include "content/public/renderer/render_frame.h"
 #include "content/public/renderer/render_view.h"
 #include "ipc/ipc_message_macros.h"
 #include "native_mate/dictionary.h"
@@ -35,10 +39,11 @@ namespace atom {
 
 namespace {
 
-bool GetIPCObject(v8::Isolate* isolate,
-                  v8::Local<v8::Context> context,
-                  v8::Local<v8::Object>* ipc) {
-  v8::Local<v8::String> key = mate::StringToV8(isolate, "ipc");
+bool GetHiddenObject(v8::Isolate* isolate,
+                     v8::Local<v8::Context> context,
+                     const char* name,
+                     v8::Local<v8::Object>* object) {
+  v8::Local<v8::String> key = mate::StringToV8(isolate, name);
   v8::Local<v8::Private> privateKey = v8::Private::ForApi(isolate, key);
   v8::Local<v8::Object> global_object = context->Global();
   v8::Local<v8::Value> value;
@@ -46,10 +51,16 @@ bool GetIPCObject(v8::Isolate* isolate,
     return false;
   if (value.IsEmpty() || !value->IsObject())
     return false;
-  *ipc = value->ToObject();
+  *object = value->ToObject();
   return true;
 }
 
+bool GetIPCObject(v8::Isolate* isolate,
+                  v8::Local<v8::Context> context,
+                  v8::Local<v8::Object>* ipc) {
+  return GetHiddenObject(isolate, context, "ipc", ipc);
+}
+
 std::vector<v8::Local<v8::Value>> ListValueToVector(
     v8::Isolate* isolate,
     const base::ListValue& list) {
@@ -59,6 +70,11 @@ std::vector<v8::Local<v8::Value>> ListValueToVector(
   return result;
 }
 
+// Unmaps the shared memory backing a Buffer when it is garbage collected.
+void FreeSharedMemory(char* data, void* hint) {
+  delete static_cast<base::SharedMemory*>(hint);
+}
+
 base::StringPiece NetResourceProvider(int key) {
   if (key == IDR_DIR_HEADER_HTML) {
     base::StringPiece html_data =
@@ -136,6 +152,9 @@ bool AtomRenderViewObserver::OnMessageReceived(const IPC::Message& message) {
   bool handled = true;
   IPC_BEGIN_MESSAGE_MAP(AtomRenderViewObserver, message)
     IPC_MESSAGE_HANDLER(AtomViewMsg_Message, OnBrowserMessage)
+    IPC_MESSAGE_HANDLER(AtomViewMsg_InvokeReply, OnInvokeReply)
+    IPC_MESSAGE_HANDLER(AtomViewMsg_Message_SharedMemory,
+                        OnBrowserMessageSharedMemory)
     IPC_MESSAGE_HANDLER(AtomViewMsg_Offscreen, OnOffscreen)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
@@ -170,6 +189,83 @@ void AtomRenderViewObserver::OnBrowserMessage(bool send_to_all,
   }
 }
 
+void AtomRenderViewObserver::OnInvokeReply(
+    int frame_routing_id, const std::vector<uint8_t>& payload) {
+  // Only the frame that made the request can see the reply.
+  content::RenderFrame* render_frame =
+      content::RenderFrame::FromRoutingID(frame_routing_id);
+  if (!render_frame || render_frame->GetRenderView() != render_view())
+    return;
+
+  blink::WebLocalFrame* frame = render_frame->GetWebFrame();
+  v8::Isolate* isolate = blink::mainThreadIsolate();
+  v8::HandleScope handle_scope(isolate);
+
+  v8::Local<v8::Context> context = renderer_client_->GetContext(frame, isolate);
+  v8::Context::Scope context_scope(context);
+
+  // The pending requests are kept by the internal emitter of ipcRenderer, so
+  // the reply does not depend on the listeners of the public one.
+  v8::Local<v8::Object> ipc_internal;
+  if (!node::Environment::GetCurrent(context) ||
+      !GetHiddenObject(isolate, context, "ipcInternal", &ipc_internal))
+    return;
+
+  v8::Local<v8::Value> reply;
+  std::vector<v8::Local<v8::Value>> args;
+  if (!DeserializeV8Value(isolate, payload).ToLocal(&reply) ||
+      !mate::ConvertFromV8(isolate, reply, &args))
+    return;
+
+  mate::EmitEvent(isolate, ipc_internal, "invoke-reply", args);
+}
+
+void AtomRenderViewObserver::OnBrowserMessageSharedMemory(
+    const base::string16& channel,
+    const base::SharedMemoryHandle& handle,
+    uint32_t size) {
+  // Owns the handle, so it is closed on every early return.
+  std::unique_ptr<base::SharedMemory> shared_memory(
+      new base::SharedMemory(handle, false));
+  if (!document_created_ || !render_view()->GetWebView())
+    return;
+
+  blink::WebFrame* frame = render_view()->GetWebView()->mainFrame();
+  if (!frame || frame->isWebRemoteFrame() || !shared_memory->Map(size))
+    return;
+
+  v8::Isolate* isolate = blink::mainThreadIsolate();
+  v8::HandleScope handle_scope(isolate);
+
+  v8::Local<v8::Context> context = renderer_client_->GetContext(frame, isolate);
+  v8::Context::Scope context_scope(context);
+
+  // Only emit IPC event for context with node integration.
+  node::Environment* env = node::Environment::GetCurrent(context);
+  if (!env)
+    return;
+
+  v8::Local<v8::Object> ipc;
+  if (!GetIPCObject(isolate, context, &ipc))
+    return;
+
+  // The Buffer owns the mapping, so the data is never copied.
+  v8::Local<v8::Object> buffer;
+  if (!node::Buffer::New(isolate,
+                         static_cast<char*>(shared_memory->memory()), size,
+                         &FreeSharedMemory, shared_memory.get())
+           .ToLocal(&buffer))
+    return;
+  shared_memory.release();
+
+  TRACE_EVENT0("devtools.timeline", "FunctionCall");
+  // Insert the Event object, event.sender is ipc.
+  mate::Dictionary event = mate::Dictionary::CreateEmpty(isolate);
+  event.Set("sender", ipc);
+  std::vector<v8::Local<v8::Value>> args = { event.GetHandle(), buffer };
+  mate::EmitEvent(isolate, ipc, channel, args);
+}
+
 void AtomRenderViewObserver::OnOffscreen() {
   blink::WebView::setUseExternalPopupMenus(false);
 }
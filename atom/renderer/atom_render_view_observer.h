@@ -5,6 +5,11 @@
 #ifndef ATOM_RENDERER_ATOM_RENDER_VIEW_OBSERVER_H_
 #define ATOM_RENDERER_ATOM_RENDER_VIEW_OBSERVER_H_
 
+#include <stdint.h>
+
+#include <vector>
+
+#include "base/memory/shared_memory_handle.h"
 #include "base/strings/string16.h"
 #include "content/public/renderer/render_view_observer.h"
 #include "third_party/WebKit/public/web/WebFrame.h"
@@ -39,6 +44,11 @@ class AtomRenderViewObserver : public content::RenderViewObserver {
   void OnBrowserMessage(bool send_to_all,
                         const base::string16& channel,
                         const base::ListValue& args);
+  void OnInvokeReply(int frame_routing_id,
+                     const std::vector<uint8_t>& payload);
+  void OnBrowserMessageSharedMemory(const base::string16& channel,
+                                    const base::SharedMemoryHandle& handle,
+                                    uint32_t size);
 
   void OnOffscreen();
 
@@ -193,6 +193,9 @@ Object.assign(BrowserWindow.prototype, {
   capturePage (...args) {
     return this.webContents.capturePage(...args)
   },
+  capturePageRegions (...args) {
+    return this.webContents.capturePageRegions(...args)
+  },
   setTouchBar (touchBar) {
     electron.TouchBar._setOnWindow(touchBar, this)
   }
@@ -10,6 +10,31 @@ emitter.removeAllListeners = function (...args) {
   removeAllListeners(...args)
 }
 
+// Handlers of ipcRenderer.invoke, one for each channel.
+const invokeHandlers = new Map()
+
+emitter.handle = function (channel, handler) {
+  if (typeof handler !== 'function') {
+    throw new TypeError('Second argument has to be a function')
+  }
+  if (invokeHandlers.has(channel)) {
+    throw new Error(`A handler is already registered for '${channel}'`)
+  }
+  invokeHandlers.set(channel, handler)
+}
+
+emitter.removeHandler = function (channel) {
+  invokeHandlers.delete(channel)
+}
+
+emitter._invoke = function (channel, event, args) {
+  const handler = invokeHandlers.get(channel)
+  if (!handler) {
+    return Promise.reject(new Error(`No handler registered for '${channel}'`))
+  }
+  return new Promise((resolve) => resolve(handler(event, ...args)))
+}
+
 // Do not throw exception when channel name is "error".
 emitter.on('error', () => {})
 
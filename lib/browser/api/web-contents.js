@@ -99,6 +99,18 @@ WebContents.prototype.sendToAll = function (channel, ...args) {
   return this._send(true, channel, args)
 }
 
+WebContents.prototype.sendBuffer = function (channel, buffer) {
+  if (channel == null) throw new Error('Missing required channel argument')
+  if (!ArrayBuffer.isView(buffer)) {
+    throw new TypeError('Second argument has to be a Buffer or TypedArray')
+  }
+  // Shared memory can not be empty.
+  if (buffer.byteLength === 0) {
+    return this._send(false, channel, [Buffer.alloc(0)])
+  }
+  return this._sendSharedMemory(channel, buffer)
+}
+
 // Following methods are mapped to webFrame.
 const webFrameMethods = [
   'insertCSS',
@@ -213,6 +225,22 @@ WebContents.prototype.printToPDF = function (options, callback) {
   this._printToPDF(printingSetting, callback)
 }
 
+// Regions written to a caller supplied buffer get the buffer back.
+WebContents.prototype.capturePageRegions = function (regions, callback) {
+  if (!Array.isArray(regions)) {
+    throw new Error('Must pass an array of regions')
+  }
+  if (typeof callback !== 'function') {
+    throw new Error('Must pass function as an argument')
+  }
+  this._capturePageRegions(regions, (images, captured) => {
+    // A buffer is only returned when the region was written to it.
+    callback(images.map((image, index) => {
+      return captured[index] && regions[index].buffer ? regions[index].buffer : image
+    }))
+  })
+}
+
 WebContents.prototype.getZoomLevel = function (callback) {
   if (typeof callback !== 'function') {
     throw new Error('Must pass function as an argument')
@@ -246,6 +274,31 @@ WebContents.prototype._init = function () {
   this.on('ipc-message', function (event, [channel, ...args]) {
     ipcMain.emit(channel, event, ...args)
   })
+  this.on('ipc-message-batch', function (event, [messages]) {
+    for (const [channel, ...args] of messages) {
+      ipcMain.emit(channel, event, ...args)
+    }
+  })
+  this.on('ipc-invoke', function (event, frameRoutingId, [requestId, channel, ...args]) {
+    const toError = (error) => ({
+      message: error instanceof Error ? error.message : String(error),
+      stack: error instanceof Error ? error.stack : undefined
+    })
+    // The reply is structured cloned and only sent to the requesting frame.
+    const reply = (error, result) => {
+      if (this.isDestroyed()) return
+      try {
+        this._sendInvokeReply(frameRoutingId, [requestId, error, result])
+      } catch (cloneError) {
+        this._sendInvokeReply(frameRoutingId, [requestId, toError(cloneError)])
+      }
+    }
+    ipcMain._invoke(channel, event, args).then((result) => {
+      reply(null, result)
+    }, (error) => {
+      reply(toError(error))
+    })
+  })
   this.on('ipc-message-sync', function (event, [channel, ...args]) {
     Object.defineProperty(event, 'returnValue', {
       set: function (value) {
@@ -1 +1,44 @@
-module.exports = process.atomBinding('native_image')
+const nativeImage = process.atomBinding('native_image')
+
+const NativeImage = Object.getPrototypeOf(nativeImage.createEmpty())
+
+// The work of the async methods is done on a worker pool, the result is either
+// passed to the callback or returned when there was nothing to do.
+const callAsync = function (method, self, args) {
+  return new Promise((resolve) => {
+    const result = method.call(self, ...args, resolve)
+    if (result !== undefined) resolve(result)
+  })
+}
+
+NativeImage.toPNGAsync = function (options = {}) {
+  return callAsync(this._toPNGAsync, this, [options])
+}
+
+NativeImage.toJPEGAsync = function (quality) {
+  return callAsync(this._toJPEGAsync, this, [quality])
+}
+
+NativeImage.toDataURLAsync = function (options = {}) {
+  return callAsync(this._toDataURLAsync, this, [options])
+}
+
+NativeImage.resizeAsync = function (options) {
+  return callAsync(this._resizeAsync, this, [options])
+}
+
+nativeImage.createFromPathAsync = function (path) {
+  return new Promise((resolve) => {
+    const image = nativeImage._createFromPathAsync(path, (image, isTemplate) => {
+      if (isTemplate) image.setTemplateImage(true)
+      resolve(image)
+    })
+    if (image !== undefined) resolve(image)
+  })
+}
+
+nativeImage.createFromBufferAsync = function (buffer, options = {}) {
+  return callAsync(nativeImage._createFromBufferAsync, null, [buffer, options])
+}
+
+module.exports = nativeImage
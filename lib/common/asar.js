@@ -237,6 +237,27 @@
       fs.writeSync(logFDs[asarPath], offset + ': ' + filePath + '\n')
     }
 
+    // Reads the content of a packed file and inflates it when compressed.
+    // Unless |writable| is set, the returned Buffer may point into the
+    // read-only mapping of the archive and must not be handed to user code.
+    const readPackedFileSync = function (archive, info, writable) {
+      const size = info.compressed ? info.compressedSize : info.size
+      let buffer = archive.read(info.offset, size)
+      if (buffer) {
+        if (writable && !info.compressed) {
+          buffer = Buffer.from(buffer)
+        }
+      } else {
+        const fd = archive.getFd()
+        if (!(fd >= 0)) {
+          return null
+        }
+        buffer = new Buffer(size)
+        fs.readSync(fd, buffer, 0, size, info.offset)
+      }
+      return info.compressed ? require('zlib').inflateSync(buffer) : buffer
+    }
+
     const {lstatSync} = fs
     fs.lstatSync = function (p) {
       const [isAsar, asarPath, filePath] = splitPath(p)
@@ -488,14 +509,20 @@
         throw new TypeError('Bad arguments')
       }
       const {encoding} = options
-      const buffer = new Buffer(info.size)
+      const size = info.compressed ? info.compressedSize : info.size
+      const buffer = new Buffer(size)
       const fd = archive.getFd()
       if (!(fd >= 0)) {
         return notFoundError(asarPath, filePath, callback)
       }
       logASARAccess(asarPath, filePath, info.offset)
-      fs.read(fd, buffer, 0, info.size, info.offset, function (error) {
-        callback(error, encoding ? buffer.toString(encoding) : buffer)
+      fs.read(fd, buffer, 0, size, info.offset, function (error) {
+        if (error || !info.compressed) {
+          return callback(error, encoding ? buffer.toString(encoding) : buffer)
+        }
+        require('zlib').inflate(buffer, function (error, result) {
+          callback(error, encoding && result ? result.toString(encoding) : result)
+        })
       })
     }
 
@@ -536,13 +563,11 @@
         throw new TypeError('Bad arguments')
       }
       const {encoding} = options
-      const buffer = new Buffer(info.size)
-      const fd = archive.getFd()
-      if (!(fd >= 0)) {
+      logASARAccess(asarPath, filePath, info.offset)
+      const buffer = readPackedFileSync(archive, info, !encoding)
+      if (!buffer) {
         notFoundError(asarPath, filePath)
       }
-      logASARAccess(asarPath, filePath, info.offset)
-      fs.readSync(fd, buffer, 0, info.size, info.offset)
       if (encoding) {
         return buffer.toString(encoding)
       } else {
@@ -609,13 +634,11 @@
           encoding: 'utf8'
         })
       }
-      const buffer = new Buffer(info.size)
-      const fd = archive.getFd()
-      if (!(fd >= 0)) {
+      logASARAccess(asarPath, filePath, info.offset)
+      const buffer = readPackedFileSync(archive, info, false)
+      if (!buffer) {
         return
       }
-      logASARAccess(asarPath, filePath, info.offset)
-      fs.readSync(fd, buffer, 0, info.size, info.offset)
       return buffer.toString('utf8')
     }
 
@@ -1,20 +1,125 @@
 'use strict'
 
+const {EventEmitter} = require('events')
 const binding = process.atomBinding('ipc')
 const v8Util = process.atomBinding('v8_util')
 
 // Created by init.js.
 const ipcRenderer = v8Util.getHiddenValue(global, 'ipc')
 
-ipcRenderer.send = function (...args) {
-  return binding.send('ipc-message', args)
+// Channels with batching enabled, mapped to whether they are coalesced.
+const batchedChannels = new Map()
+// Messages waiting to be flushed, and the index of the pending message of
+// each coalesced channel.
+let pendingMessages = []
+let coalescedMessages = new Map()
+
+// Also called before sending any message that is not batched, so it can not
+// overtake the batched messages sent before it.
+const flushMessages = function () {
+  if (pendingMessages.length === 0) return
+  const messages = pendingMessages
+  pendingMessages = []
+  coalescedMessages = new Map()
+  binding.send('ipc-message-batch', [messages])
+}
+
+const queueMessage = function (channel, args) {
+  if (batchedChannels.get(channel) && coalescedMessages.has(channel)) {
+    // Latest value wins, but keeps the position of the first message.
+    pendingMessages[coalescedMessages.get(channel)] = [channel, ...args]
+    return
+  }
+
+  if (pendingMessages.length === 0) {
+    Promise.resolve().then(flushMessages)
+  }
+  if (batchedChannels.get(channel)) {
+    coalescedMessages.set(channel, pendingMessages.length)
+  }
+  pendingMessages.push([channel, ...args])
 }
 
+ipcRenderer.send = function (channel, ...args) {
+  if (batchedChannels.has(channel)) {
+    return queueMessage(channel, args)
+  }
+  flushMessages()
+  return binding.send('ipc-message', [channel, ...args])
+}
+
+ipcRenderer.enableBatching = function (channel, options = {}) {
+  batchedChannels.set(channel, Boolean(options.coalesce))
+}
+
+ipcRenderer.disableBatching = function (channel) {
+  batchedChannels.delete(channel)
+}
+
+ipcRenderer.sendSerialized = function (...args) {
+  flushMessages()
+  return binding.sendSerialized('ipc-message', args)
+}
+
+ipcRenderer.sendBuffer = function (channel, buffer) {
+  if (!ArrayBuffer.isView(buffer)) {
+    throw new TypeError('Second argument has to be a Buffer or TypedArray')
+  }
+  flushMessages()
+  // Shared memory can not be empty.
+  if (buffer.byteLength === 0) {
+    return binding.send('ipc-message', [channel, Buffer.alloc(0)])
+  }
+  return binding.sendSharedMemory(channel, buffer)
+}
+
+// Requests of ipcRenderer.invoke waiting for replies. The replies are only
+// sent to this frame, and emitted on an internal emitter so they do not depend
+// on the listeners of ipcRenderer.
+const ipcInternal = new EventEmitter()
+v8Util.setHiddenValue(global, 'ipcInternal', ipcInternal)
+const pendingInvokes = new Map()
+let nextInvokeId = 0
+
+ipcRenderer.invoke = function (channel, ...args) {
+  return new Promise((resolve, reject) => {
+    const requestId = ++nextInvokeId
+    pendingInvokes.set(requestId, {resolve, reject})
+    let sent = false
+    try {
+      flushMessages()
+      sent = binding.sendInvoke([requestId, channel, ...args])
+    } catch (error) {
+      pendingInvokes.delete(requestId)
+      return reject(error)
+    }
+    if (!sent) {
+      pendingInvokes.delete(requestId)
+      reject(new Error('Unable to send the invoke request'))
+    }
+  })
+}
+
+ipcInternal.on('invoke-reply', function (requestId, error, result) {
+  const pending = pendingInvokes.get(requestId)
+  if (!pending) return
+  pendingInvokes.delete(requestId)
+  if (error) {
+    const rejection = new Error(error.message)
+    if (error.stack) rejection.stack = error.stack
+    pending.reject(rejection)
+  } else {
+    pending.resolve(result)
+  }
+})
+
 ipcRenderer.sendSync = function (...args) {
+  flushMessages()
   return JSON.parse(binding.sendSync('ipc-message-sync', args))
 }
 
 ipcRenderer.sendToHost = function (...args) {
+  flushMessages()
   return binding.send('ipc-message-host', args)
 }
 
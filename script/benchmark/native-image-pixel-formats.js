@@ -0,0 +1,70 @@
+// Compares the native pixel format conversions of nativeImage with the same
+// conversions written in JavaScript.
+//
+// Usage: electron script/benchmark/native-image-pixel-formats.js [size]
+
+const {app, nativeImage} = require('electron')
+
+const size = parseInt(process.argv[2], 10) || 2048
+const iterations = 20
+
+const measure = function (name, fn) {
+  fn()
+  const start = process.hrtime()
+  for (let i = 0; i < iterations; i++) fn()
+  const [seconds, nanoseconds] = process.hrtime(start)
+  const milliseconds = (seconds * 1e3 + nanoseconds / 1e6) / iterations
+  const megapixels = size * size / 1e6 / (milliseconds / 1e3)
+  console.log(`${name}: ${milliseconds.toFixed(2)} ms, ${megapixels.toFixed(0)} MP/s`)
+}
+
+const toRGBA = function (bgra) {
+  const rgba = Buffer.allocUnsafe(bgra.length)
+  for (let i = 0; i < bgra.length; i += 4) {
+    const alpha = bgra[i + 3]
+    const scale = alpha === 0 ? 0 : 255 / alpha
+    rgba[i] = Math.min(255, Math.round(bgra[i + 2] * scale))
+    rgba[i + 1] = Math.min(255, Math.round(bgra[i + 1] * scale))
+    rgba[i + 2] = Math.min(255, Math.round(bgra[i] * scale))
+    rgba[i + 3] = alpha
+  }
+  return rgba
+}
+
+const toGray = function (bgra) {
+  const gray = Buffer.allocUnsafe(bgra.length / 4)
+  for (let i = 0, j = 0; i < bgra.length; i += 4, j++) {
+    gray[j] = (bgra[i] * 29 + bgra[i + 1] * 150 + bgra[i + 2] * 77 + 128) >> 8
+  }
+  return gray
+}
+
+const toRGB565 = function (bgra) {
+  const rgb565 = Buffer.allocUnsafe(bgra.length / 2)
+  for (let i = 0, j = 0; i < bgra.length; i += 4, j += 2) {
+    rgb565.writeUInt16LE((bgra[i] >> 3) | ((bgra[i + 1] >> 2) << 5) |
+                         ((bgra[i + 2] >> 3) << 11), j)
+  }
+  return rgb565
+}
+
+app.once('ready', () => {
+  const pixels = Buffer.allocUnsafe(size * size * 4)
+  for (let i = 0; i < pixels.length; i += 4) {
+    pixels[i + 3] = (i >> 2) & 0xff
+    pixels[i] = pixels[i + 1] = pixels[i + 2] = pixels[i + 3] >> 1
+  }
+  const image = nativeImage.createFromBitmap(pixels, {width: size, height: size})
+  const bgra = image.toBitmap()
+
+  console.log(`${size}x${size} pixels, average of ${iterations} runs`)
+  measure('bgra copy', () => image.toBitmap())
+  measure('rgba unpremultiplied (native)', () => image.toBitmap({format: 'rgba', premultiplied: false}))
+  measure('rgba unpremultiplied (js)', () => toRGBA(bgra))
+  measure('gray (native)', () => image.toBitmap({format: 'gray'}))
+  measure('gray (js)', () => toGray(bgra))
+  measure('rgb565 (native)', () => image.toBitmap({format: 'rgb565'}))
+  measure('rgb565 (js)', () => toRGB565(bgra))
+  measure('createFromBitmap rgba', () => nativeImage.createFromBitmap(bgra, {width: size, height: size, format: 'rgba', premultiplied: false}))
+  app.quit()
+})
@@ -0,0 +1,93 @@
+// Replays a URL corpus against a large set of webRequest URL patterns, and
+// compares it with replaying the corpus without any patterns.
+//
+// Every request is blocked by a final catch-all rule after testing all the
+// patterns, so no request reaches the network.
+//
+// Usage: electron script/benchmark/web-request-url-patterns.js [patterns] [corpus]
+//
+// The corpus file has one URL per line, a synthetic corpus is used when it is
+// omitted.
+
+const {app, net, session} = require('electron')
+const fs = require('fs')
+
+const patternCount = parseInt(process.argv[2], 10) || 10000
+const corpusPath = process.argv[3]
+
+const tlds = ['com', 'net', 'org', 'io', 'co.uk']
+const words = ['ads', 'track', 'pixel', 'beacon', 'metrics', 'banner', 'stats']
+
+const createPatterns = function () {
+  const patterns = []
+  for (let i = 0; i < patternCount; i++) {
+    const word = words[i % words.length]
+    const tld = tlds[i % tlds.length]
+    switch (i % 4) {
+      case 0:
+        patterns.push(`*://*.${word}${i}.${tld}/*`)
+        break
+      case 1:
+        patterns.push(`https://cdn${i}.example.${tld}/${word}/*`)
+        break
+      case 2:
+        patterns.push(`*://*/*/${word}-${i}.js*`)
+        break
+      default:
+        patterns.push(`http://*/${word}/${i}/*`)
+    }
+  }
+  return patterns
+}
+
+const createCorpus = function () {
+  const corpus = []
+  for (let i = 0; i < 2000; i++) {
+    const word = words[i % words.length]
+    const tld = tlds[i % tlds.length]
+    corpus.push(`https://www.site${i}.${tld}/static/${word}/app-${i}.js?v=${i}`)
+  }
+  return corpus
+}
+
+const replay = function (corpus) {
+  return new Promise((resolve) => {
+    let pending = corpus.length
+    const done = () => { if (--pending === 0) resolve() }
+    for (const url of corpus) {
+      const request = net.request(url)
+      request.on('error', done)
+      request.on('response', done)
+      request.end()
+    }
+  })
+}
+
+const measure = async function (name, rules, corpus) {
+  session.defaultSession.webRequest.setRules(rules)
+  await replay(corpus)
+  const start = process.hrtime()
+  await replay(corpus)
+  const [seconds, nanoseconds] = process.hrtime(start)
+  const milliseconds = seconds * 1e3 + nanoseconds / 1e6
+  const microseconds = milliseconds * 1e3 / corpus.length
+  console.log(`${name}: ${milliseconds.toFixed(1)} ms, ${microseconds.toFixed(1)} us per request`)
+}
+
+app.once('ready', async () => {
+  const corpus = corpusPath
+    ? fs.readFileSync(corpusPath, 'utf8').split('\n').filter((url) => url)
+    : createCorpus()
+  const patterns = createPatterns()
+
+  console.log(`${corpus.length} URLs, ${patterns.length} patterns`)
+  await measure('no patterns', [{action: 'block'}], corpus)
+  await measure('one rule', [
+    {action: 'block', urls: patterns},
+    {action: 'block'}
+  ], corpus)
+  await measure('a rule per pattern', patterns.map((url) => {
+    return {action: 'block', urls: [url]}
+  }).concat([{action: 'block'}]), corpus)
+  app.quit()
+})
@@ -8,7 +8,7 @@ const qs = require('querystring')
 const http = require('http')
 const {closeWindow} = require('./window-helpers')
 
-const {ipcRenderer, remote, screen} = require('electron')
+const {ipcRenderer, nativeImage, remote, screen} = require('electron')
 const {app, ipcMain, BrowserWindow, protocol, webContents} = remote
 
 const isCI = remote.getGlobal('isCi')
@@ -457,6 +457,50 @@ describe('BrowserWindow module', function () {
     })
   })
 
+  describe('BrowserWindow.capturePageRegions(regions, callback)', function () {
+    it('calls the callback with a result for each region', function (done) {
+      const buffer = Buffer.alloc(10 * 10 * 4, 0xff)
+      w.capturePageRegions([
+        {x: 0, y: 0, width: 100, height: 100},
+        {x: 50, y: 50, width: 10, height: 10, scaleFactor: 1, buffer: buffer}
+      ], function (results) {
+        assert.equal(results.length, 2)
+        assert.equal(results[0].isEmpty(), true)
+        // Nothing was captured, so the buffer is neither returned nor changed.
+        assert.notEqual(results[1], buffer)
+        assert.equal(results[1].isEmpty(), true)
+        assert.equal(buffer.every((byte) => byte === 0xff), true)
+        done()
+      })
+    })
+
+    it('throws when a scale factor is out of range', function () {
+      assert.throws(function () {
+        w.capturePageRegions([{x: 0, y: 0, width: 10, height: 10, scaleFactor: 0}], function () {})
+      }, /Invalid region at index 0/)
+      assert.throws(function () {
+        w.capturePageRegions([
+          {x: 0, y: 0, width: 10, height: 10},
+          {x: 0, y: 0, width: 10, height: 10, scaleFactor: 1000}
+        ], function () {})
+      }, /Invalid region at index 1/)
+    })
+
+    it('throws when the callback is missing', function () {
+      assert.throws(function () {
+        w.capturePageRegions([{x: 0, y: 0, width: 10, height: 10}])
+      }, /Must pass function as an argument/)
+    })
+
+    it('throws when a buffer is too small', function () {
+      assert.throws(function () {
+        w.capturePageRegions([
+          {x: 0, y: 0, width: 10, height: 10, scaleFactor: 1, buffer: Buffer.alloc(4)}
+        ], function () {})
+      }, /The buffer of region 0 is too small/)
+    })
+  })
+
   describe('BrowserWindow.setSize(width, height)', function () {
     it('sets the window size', function (done) {
       var size = [300, 400]
@@ -1484,6 +1528,44 @@ describe('BrowserWindow module', function () {
       })
     })
 
+    it('subscribes to encoded frames', function (done) {
+      let called = false
+      w.loadURL('file://' + fixtures + '/api/frame-subscriber.html')
+      w.webContents.on('dom-ready', function () {
+        w.webContents.beginFrameSubscription({encoder: {format: 'jpeg', quality: 80}}, function (data, dirtyRect, frame) {
+          // This callback might be called twice.
+          if (called) return
+          called = true
+
+          assert.equal(frame.format, 'jpeg')
+          assert.notEqual(data.length, 0)
+          w.webContents.endFrameSubscription()
+          done()
+        })
+      })
+    })
+
+    it('subscribes to i420 video frames', function (done) {
+      let called = false
+      w.loadURL('file://' + fixtures + '/api/frame-subscriber.html')
+      w.webContents.on('dom-ready', function () {
+        w.webContents.beginFrameSubscription({format: 'i420'}, function (data, dirtyRect, frame) {
+          // This callback might be called twice.
+          if (called) return
+          called = true
+
+          assert.equal(frame.format, 'i420')
+          assert.equal(frame.planes.length, 3)
+          assert.equal(frame.planes[0].data, data)
+          assert.equal(frame.size.width % 2, 0)
+          assert(frame.planes[0].stride >= frame.size.width)
+          assert(frame.planes[1].data.length < data.length)
+          w.webContents.endFrameSubscription()
+          done()
+        })
+      })
+    })
+
     it('throws error when subscriber is not well defined', function (done) {
       w.loadURL('file://' + fixtures + '/api/frame-subscriber.html')
       try {
@@ -1492,6 +1574,21 @@ describe('BrowserWindow module', function () {
         done()
       }
     })
+
+    it('throws error when the encoder format is invalid', function () {
+      assert.throws(function () {
+        w.webContents.beginFrameSubscription({encoder: {format: 'gif'}}, function () {})
+      }, /Invalid encoder format/)
+    })
+
+    it('throws error when the frame format is invalid', function () {
+      assert.throws(function () {
+        w.webContents.beginFrameSubscription({format: 'rgb'}, function () {})
+      }, /Unknown frame format/)
+      assert.throws(function () {
+        w.webContents.beginFrameSubscription({format: 'i420', encoder: {format: 'png'}}, function () {})
+      }, /bgra format/)
+    })
   })
 
   describe('savePage method', function () {
@@ -2358,6 +2455,118 @@ describe('BrowserWindow module', function () {
         w.loadURL('file://' + fixtures + '/api/offscreen-rendering.html')
       })
     })
+
+    describe('window.webContents.getFrameStats()', function () {
+      it('reports frame pacing counters', function (done) {
+        w.webContents.once('paint', function () {
+          const stats = w.webContents.getFrameStats()
+          assert.equal(typeof stats.droppedFrames, 'number')
+          assert.equal(typeof stats.coalescedFrames, 'number')
+          assert(stats.frameRate > 0 && stats.frameRate <= 60)
+          done()
+        })
+        w.loadURL('file://' + fixtures + '/api/offscreen-rendering.html')
+      })
+
+      it('returns null for onscreen windows', function () {
+        const onscreen = new BrowserWindow({show: false})
+        assert.equal(onscreen.webContents.getFrameStats(), null)
+        onscreen.destroy()
+      })
+    })
+  })
+
+  describe('offscreen rendering with encoder', function () {
+    beforeEach(function () {
+      if (w != null) w.destroy()
+      w = new BrowserWindow({
+        show: false,
+        width: 100,
+        height: 100,
+        webPreferences: {
+          backgroundThrottling: false,
+          offscreen: {encoder: {format: 'png'}}
+        }
+      })
+    })
+
+    it('throws when the encoder options are invalid', function () {
+      assert.throws(function () {
+        return new BrowserWindow({
+          show: false,
+          webPreferences: {offscreen: {encoder: {format: 'gif'}}}
+        })
+      }, /Invalid encoder format/)
+    })
+
+    it('delivers encoded frames', function (done) {
+      w.webContents.once('paint', function (event, rect, frame) {
+        assert.equal(frame.format, 'png')
+        assert.ok(frame.size.width > 0)
+        assert.ok(frame.encodeTime >= 0)
+        const image = nativeImage.createFromBuffer(frame.data)
+        assert.deepEqual(image.getSize(), frame.size)
+        done()
+      })
+      w.loadURL('file://' + fixtures + '/api/offscreen-rendering.html')
+    })
+  })
+
+  describe('offscreen rendering with dirty rects', function () {
+    beforeEach(function () {
+      if (w != null) w.destroy()
+      w = new BrowserWindow({
+        show: false,
+        width: 100,
+        height: 100,
+        webPreferences: {
+          backgroundThrottling: false,
+          offscreen: {dirtyRects: true}
+        }
+      })
+    })
+
+    it('delivers the changed parts of frames', function (done) {
+      w.webContents.once('paint', function (event, rect, parts) {
+        assert.ok(parts.length > 0)
+        parts.forEach(function (part) {
+          assert.equal(part.stride, part.rect.width * 4)
+          assert.equal(part.data.length, part.stride * part.rect.height)
+        })
+        done()
+      })
+      w.loadURL('file://' + fixtures + '/api/offscreen-rendering.html')
+    })
+  })
+
+  describe('offscreen rendering with shared buffers', function () {
+    beforeEach(function () {
+      if (w != null) w.destroy()
+      w = new BrowserWindow({
+        show: false,
+        width: 100,
+        height: 100,
+        webPreferences: {
+          backgroundThrottling: false,
+          offscreen: {sharedBuffers: 2}
+        }
+      })
+    })
+
+    it('delivers frames in shared buffers', function (done) {
+      w.webContents.once('paint', function (event, rect, frame) {
+        assert.ok(frame.index === 0 || frame.index === 1)
+        assert.ok(frame.size.width > 0)
+        assert.equal(frame.stride, frame.size.width * 4)
+        w.webContents.releasePaintBuffer(frame.index)
+        done()
+      })
+      w.loadURL('file://' + fixtures + '/api/offscreen-rendering.html')
+    })
+
+    it('is an offscreen window', function () {
+      assert.equal(w.webContents.isOffscreen(), true)
+    })
   })
 })
 
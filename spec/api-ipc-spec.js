@@ -473,6 +473,192 @@ describe('ipc module', function () {
     })
   })
 
+  describe('ipcRenderer.sendSerialized', function () {
+    it('keeps the types of structured clonable values', function (done) {
+      ipcRenderer.once('describe-values', function (event, types) {
+        assert.deepEqual(types, [
+          '[object Map]',
+          '[object Set]',
+          '[object Date]',
+          '[object Uint8Array]',
+          '[object Float64Array]'
+        ])
+        done()
+      })
+      ipcRenderer.sendSerialized('describe-values', new Map([['a', 1]]),
+        new Set([1]), new Date(), new Uint8Array([1, 2]), new Float64Array(4))
+    })
+
+    it('keeps cyclic references', function (done) {
+      const child = {hello: 'world'}
+      child.child = child
+
+      ipcRenderer.once('message', function (event, childValue) {
+        assert.equal(childValue.hello, 'world')
+        done()
+      })
+      ipcRenderer.sendSerialized('message', child)
+    })
+
+    it('throws when sending functions', function () {
+      assert.throws(function () {
+        ipcRenderer.sendSerialized('message', function () {})
+      })
+    })
+  })
+
+  describe('ipcRenderer.sendBuffer', function () {
+    it('sends the buffer to the main process', function (done) {
+      const buffer = Buffer.alloc(4 * 1024 * 1024, 'electron')
+      ipcRenderer.once('message', function (event, message) {
+        assert.ok(buffer.equals(message))
+        done()
+      })
+      ipcRenderer.sendBuffer('message', buffer)
+    })
+
+    it('sends typed arrays', function (done) {
+      const array = new Float32Array([1, 2, 3])
+      ipcRenderer.once('message', function (event, message) {
+        assert.ok(Buffer.from(array.buffer).equals(message))
+        done()
+      })
+      ipcRenderer.sendBuffer('message', array)
+    })
+
+    it('sends empty buffers', function (done) {
+      ipcRenderer.once('message', function (event, message) {
+        assert.equal(message.length, 0)
+        done()
+      })
+      ipcRenderer.sendBuffer('message', Buffer.alloc(0))
+    })
+
+    it('throws when the argument is not a buffer', function () {
+      assert.throws(function () {
+        ipcRenderer.sendBuffer('message', 'not a buffer')
+      }, /Second argument has to be a Buffer or TypedArray/)
+    })
+  })
+
+  describe('webContents.sendBuffer', function () {
+    it('sends the buffer to the renderer', function (done) {
+      const buffer = Buffer.alloc(4 * 1024 * 1024, 'electron')
+      ipcRenderer.once('message', function (event, message) {
+        assert.ok(buffer.equals(message))
+        done()
+      })
+      remote.getCurrentWebContents().sendBuffer('message', buffer)
+    })
+  })
+
+  describe('ipcRenderer.enableBatching', function () {
+    afterEach(function () {
+      ipcRenderer.disableBatching('message')
+      ipcRenderer.removeAllListeners('message')
+    })
+
+    it('delivers batched messages in order', function (done) {
+      const received = []
+      ipcRenderer.on('message', function (event, value) {
+        received.push(value)
+        if (received.length === 3) {
+          assert.deepEqual(received, [1, 2, 3])
+          done()
+        }
+      })
+      ipcRenderer.enableBatching('message')
+      ipcRenderer.send('message', 1)
+      ipcRenderer.send('message', 2)
+      ipcRenderer.send('message', 3)
+    })
+
+    it('does not let messages of other channels overtake batched ones', function (done) {
+      const received = []
+      ipcRenderer.on('message', function (event, value) {
+        received.push(value)
+        if (received.length === 3) {
+          assert.deepEqual(received, [1, 2, 3])
+          done()
+        }
+      })
+      ipcRenderer.enableBatching('message')
+      ipcRenderer.send('message', 1)
+      ipcRenderer.send('message-unbatched', 2)
+      ipcRenderer.send('message', 3)
+    })
+
+    it('only delivers the latest message when coalescing', function (done) {
+      ipcRenderer.on('message', function (event, value) {
+        assert.equal(value, 3)
+        done()
+      })
+      ipcRenderer.enableBatching('message', {coalesce: true})
+      ipcRenderer.send('message', 1)
+      ipcRenderer.send('message', 2)
+      ipcRenderer.send('message', 3)
+    })
+  })
+
+  describe('ipcRenderer.invoke', function () {
+    it('resolves with the result of the handler', function () {
+      return ipcRenderer.invoke('invoke-add', 1, 2).then(function (result) {
+        assert.equal(result, 3)
+      })
+    })
+
+    it('rejects with the error thrown by the handler', function () {
+      return ipcRenderer.invoke('invoke-throw', 'handler error').then(function () {
+        assert.fail('invoke should be rejected')
+      }, function (error) {
+        assert.equal(error.message, 'handler error')
+      })
+    })
+
+    it('rejects when there is no handler', function () {
+      return ipcRenderer.invoke('invoke-missing').then(function () {
+        assert.fail('invoke should be rejected')
+      }, function (error) {
+        assert.equal(error.message, "No handler registered for 'invoke-missing'")
+      })
+    })
+
+    it('can return buffers', function () {
+      return ipcRenderer.invoke('invoke-buffer', 'hello').then(function (result) {
+        assert.ok(Buffer.from('hello').equals(result))
+      })
+    })
+
+    it('keeps maps, sets and dates in the result', function () {
+      const value = {
+        map: new Map([['a', 1]]),
+        set: new Set([2]),
+        date: new Date(1000)
+      }
+      return ipcRenderer.invoke('invoke-echo', value).then(function (result) {
+        assert.ok(result.map instanceof Map)
+        assert.equal(result.map.get('a'), 1)
+        assert.ok(result.set instanceof Set)
+        assert.ok(result.set.has(2))
+        assert.ok(result.date instanceof Date)
+        assert.equal(result.date.getTime(), 1000)
+      })
+    })
+
+    it('still resolves after removing all listeners of a channel', function () {
+      ipcRenderer.removeAllListeners('ELECTRON_RENDERER_INVOKE_REPLY')
+      return ipcRenderer.invoke('invoke-add', 2, 3).then(function (result) {
+        assert.equal(result, 5)
+      })
+    })
+
+    it('throws when adding a second handler to a channel', function () {
+      assert.throws(function () {
+        ipcMain.handle('invoke-add', function () {})
+      }, /A handler is already registered for 'invoke-add'/)
+    })
+  })
+
   describe('ipc.sendSync', function () {
     afterEach(function () {
       ipcMain.removeAllListeners('send-sync-message')
@@ -243,6 +243,173 @@ describe('nativeImage module', () => {
     })
   })
 
+  describe('tiled images', () => {
+    const logoPath = path.join(__dirname, 'fixtures', 'assets', 'logo.png')
+
+    it('has the size of the whole image', () => {
+      const image = nativeImage.createFromPath(logoPath, {tiled: true})
+      assert.equal(image.isEmpty(), false)
+      assert.deepEqual(image.getSize(), {width: 538, height: 190})
+    })
+
+    it('draws the same pixels as a normal image', () => {
+      const image = nativeImage.createFromPath(logoPath)
+      const tiled = nativeImage.createFromPath(logoPath, {tiled: true, tileCacheSize: 0})
+      assert(tiled.toBitmap().equals(image.toBitmap()))
+      assert.deepEqual(nativeImage.createFromBuffer(tiled.toPNG()).getSize(), image.getSize())
+    })
+
+    it('crops without decoding the whole image', () => {
+      const image = nativeImage.createFromPath(logoPath)
+      const tiled = nativeImage.createFromBuffer(image.toPNG(), {tiled: true})
+      const bounds = {width: 25, height: 64, x: 30, y: 40}
+      const cropped = tiled.crop(bounds)
+      assert.deepEqual(cropped.getSize(), {width: 25, height: 64})
+      assert(cropped.toBitmap().equals(image.crop(bounds).toBitmap()))
+      assert(tiled.crop({width: 100, height: 100, x: 1000, y: 1000}).isEmpty())
+    })
+
+    it('resizes the requested region', () => {
+      const tiled = nativeImage.createFromPath(logoPath, {tiled: true})
+      const resized = tiled.crop({width: 200, height: 100, x: 0, y: 0}).resize({width: 100})
+      assert.deepEqual(resized.getSize(), {width: 100, height: 50})
+      assert.equal(resized.toBitmap().length, 100 * 50 * 4)
+    })
+
+    it('resizes across tiles like a normal image', () => {
+      const image = nativeImage.createFromPath(logoPath)
+      const tiled = nativeImage.createFromPath(logoPath, {tiled: true})
+      // The region spans the tile edge at x = 256.
+      const bounds = {width: 300, height: 190, x: 200, y: 0}
+      const resized = tiled.crop(bounds).resize({width: 150})
+      const expected = image.crop(bounds).resize({width: 150})
+      assert.deepEqual(resized.getSize(), expected.getSize())
+      assert(resized.toBitmap().equals(expected.toBitmap()))
+    })
+
+    it('falls back to a normal image when it can not be tiled', () => {
+      const image = nativeImage.createFromPath(path.join(__dirname, 'fixtures', 'assets', 'icon.ico'), {tiled: true})
+      assert.equal(image.isEmpty(), true)
+    })
+  })
+
+  describe('pixel formats', () => {
+    const logoPath = path.join(__dirname, 'fixtures', 'assets', 'logo.png')
+
+    it('swizzles bitmaps to RGBA', () => {
+      const image = nativeImage.createFromPath(logoPath)
+      const bgra = image.toBitmap()
+      const rgba = image.toBitmap({format: 'rgba'})
+      assert.equal(rgba.length, bgra.length)
+      for (let i = 0; i < bgra.length; i += 4) {
+        assert.equal(rgba[i], bgra[i + 2])
+        assert.equal(rgba[i + 1], bgra[i + 1])
+        assert.equal(rgba[i + 2], bgra[i])
+        assert.equal(rgba[i + 3], bgra[i + 3])
+      }
+
+      const imageB = nativeImage.createFromBitmap(rgba, {width: 538, height: 190, format: 'rgba'})
+      assert(imageB.toBitmap().equals(bgra))
+    })
+
+    it('packs smaller formats', () => {
+      const image = nativeImage.createFromPath(logoPath)
+      assert.equal(image.toBitmap({format: 'gray'}).length, 538 * 190)
+      assert.equal(image.toBitmap({format: 'rgb565'}).length, 538 * 190 * 2)
+
+      const gray = nativeImage.createFromBitmap(image.toBitmap({format: 'gray'}), {width: 538, height: 190, format: 'gray'})
+      assert.deepEqual(gray.getSize(), {width: 538, height: 190})
+      assert(gray.toBitmap({format: 'gray'}).equals(image.toBitmap({format: 'gray'})))
+    })
+
+    it('unpremultiplies colors', () => {
+      const image = nativeImage.createFromBitmap(Buffer.from([0x40, 0x20, 0x10, 0x80]), {width: 1, height: 1})
+      const bitmap = image.toBitmap({premultiplied: false})
+      assert.equal(bitmap[3], 0x80)
+      assert(Math.abs(bitmap[0] - 0x80) <= 1)
+      assert(Math.abs(bitmap[1] - 0x40) <= 1)
+      assert(Math.abs(bitmap[2] - 0x20) <= 1)
+
+      const imageB = nativeImage.createFromBitmap(bitmap, {width: 1, height: 1, premultiplied: false})
+      const premultiplied = imageB.toBitmap()
+      for (let i = 0; i < 4; i++) {
+        assert(Math.abs(premultiplied[i] - image.toBitmap()[i]) <= 1)
+      }
+    })
+
+    it('converts tiled images', () => {
+      const image = nativeImage.createFromPath(logoPath)
+      const tiled = nativeImage.createFromPath(logoPath, {tiled: true})
+      assert(tiled.toBitmap({format: 'rgba'}).equals(image.toBitmap({format: 'rgba'})))
+    })
+
+    it('throws on invalid arguments', () => {
+      const image = nativeImage.createFromPath(logoPath)
+      assert.throws(() => image.toBitmap({format: 'yuv'}), /Unknown pixel format: yuv/)
+      assert.throws(() => nativeImage.createFromBitmap(Buffer.alloc(4), {width: 2, height: 2}), /buffer is smaller/)
+      assert.throws(() => nativeImage.createFromBitmap(Buffer.alloc(4), {}), /width and height are required/)
+      assert(nativeImage.createFromBitmap(Buffer.alloc(0), {width: 0, height: 0}).isEmpty())
+    })
+  })
+
+  describe('async methods', () => {
+    const logoPath = path.join(__dirname, 'fixtures', 'assets', 'logo.png')
+
+    it('encodes the same data as the sync methods', () => {
+      const image = nativeImage.createFromPath(logoPath)
+      const resized = image.resize({width: 100, height: 100})
+      return Promise.all([
+        image.toPNGAsync(),
+        resized.toPNGAsync(),
+        resized.toDataURLAsync(),
+        nativeImage.createEmpty().toJPEGAsync(100)
+      ]).then(([png, resizedPNG, dataURL, jpeg]) => {
+        assert(png.equals(image.toPNG()))
+        assert(resizedPNG.equals(resized.toPNG()))
+        assert.equal(dataURL, resized.toDataURL())
+        assert.equal(jpeg.length, 0)
+      })
+    })
+
+    it('encodes JPEG data', () => {
+      const image = nativeImage.createFromPath(logoPath)
+      return image.toJPEGAsync(100).then((jpeg) => {
+        assert.deepEqual(nativeImage.createFromBuffer(jpeg).getSize(), {width: 538, height: 190})
+      })
+    })
+
+    it('resizes images', () => {
+      const image = nativeImage.createFromPath(logoPath)
+      return Promise.all([
+        image.resizeAsync({width: 269}),
+        image.resizeAsync({width: 0, height: 0}),
+        nativeImage.createFromPath(logoPath, {tiled: true}).resizeAsync({height: 95})
+      ]).then(([resized, empty, tiled]) => {
+        assert.deepEqual(resized.getSize(), {width: 269, height: 95})
+        assert(empty.isEmpty())
+        assert.deepEqual(tiled.getSize(), {width: 269, height: 95})
+      })
+    })
+
+    it('decodes images from paths and buffers', () => {
+      const image = nativeImage.createFromPath(logoPath)
+      const bitmap = image.toBitmap()
+      const decoded = nativeImage.createFromBufferAsync(bitmap, {width: 538, height: 190})
+      bitmap.fill(0)
+      return Promise.all([
+        nativeImage.createFromPathAsync(logoPath),
+        nativeImage.createFromBufferAsync(image.toPNG(), {scaleFactor: 2.0}),
+        decoded,
+        nativeImage.createFromPathAsync(path.join(__dirname, 'fixtures', 'assets', 'does-not-exist.png'))
+      ]).then(([fromPath, fromPNG, fromBitmap, missing]) => {
+        assert(fromPath.toBitmap().equals(image.toBitmap()))
+        assert.deepEqual(fromPNG.getSize(), {width: 269, height: 95})
+        assert(fromBitmap.toBitmap().equals(image.toBitmap()))
+        assert(missing.isEmpty())
+      })
+    })
+  })
+
   describe('getAspectRatio()', () => {
     it('returns the aspect ratio of the image', () => {
       assert.equal(nativeImage.createEmpty().getAspectRatio(), 1.0)
@@ -1,4 +1,6 @@
 const assert = require('assert')
+const fs = require('fs')
+const path = require('path')
 
 describe('process module', function () {
   describe('process.getCPUUsage()', function () {
@@ -23,4 +25,48 @@ describe('process module', function () {
       assert.equal(typeof ioCounters.otherTransferCount, 'number')
     })
   })
+
+  describe('process.getAsarCacheStats()', function () {
+    const fixtures = path.join(__dirname, 'fixtures')
+    const archive = path.join(fixtures, 'asar', 'logo.asar')
+    const file = path.join(archive, 'logo.png')
+
+    it('returns the archive cache statistics', function () {
+      assert.ok(fs.existsSync(file))
+      const stats = process.getAsarCacheStats()
+      assert.equal(typeof stats.archives, 'number')
+      assert.equal(typeof stats.hits, 'number')
+      assert.equal(typeof stats.misses, 'number')
+      assert.ok(stats.archives >= 1)
+      assert.ok(stats.misses >= 1)
+    })
+
+    it('reuses an opened archive', function () {
+      // fs keeps its own archive per context, so open the archive through
+      // the binding to reach the process-wide cache each time.
+      const asar = process.binding('atom_common_asar')
+      fs.readFileSync(file)
+      const before = process.getAsarCacheStats()
+      asar.createArchive(archive).destroy()
+      asar.createArchive(archive).destroy()
+      const after = process.getAsarCacheStats()
+      assert.equal(after.archives, before.archives)
+      assert.ok(after.hits >= before.hits + 2)
+    })
+
+    it('shares opened archives with workers', function (done) {
+      const webview = new WebView()
+      webview.addEventListener('ipc-message', function (e) {
+        const [before, after] = e.args
+        assert.equal(e.channel, 'stats')
+        assert.equal(after.archives, before.archives)
+        assert.ok(after.hits > before.hits)
+        webview.remove()
+        done()
+      })
+      webview.src = 'file://' + fixtures + '/pages/worker-asar.html'
+      webview.setAttribute('webpreferences', 'nodeIntegration, nodeIntegrationInWorker')
+      document.body.appendChild(webview)
+    })
+  })
 })
@@ -285,6 +285,163 @@ describe('protocol module', function () {
       })
     })
 
+    it('serves cached responses without calling the handler', function (done) {
+      var calls = 0
+      var handler = function (request, callback) {
+        calls++
+        callback({
+          data: buffer,
+          headers: {'Cache-Control': 'max-age=60'}
+        })
+      }
+      var url = protocolName + '://fake-host/cached'
+      protocol.registerBufferProtocol(protocolName, handler, {cacheSize: 1024}, function (error) {
+        if (error) return done(error)
+        $.get(url).then(function (data) {
+          assert.equal(data, text)
+          return $.get(url)
+        }).then(function (data, status, request) {
+          assert.equal(data, text)
+          assert.equal(request.getResponseHeader('Cache-Control'), 'max-age=60')
+          assert.equal(calls, 1)
+          done()
+        }, function (xhr, errorType, error) {
+          done(error)
+        })
+      })
+    })
+
+    it('revalidates stale responses with their ETag', function (done) {
+      var calls = 0
+      var revalidated = false
+      var handler = function (request, callback) {
+        calls++
+        if (request.headers && request.headers['If-None-Match'] === '"v1"') {
+          revalidated = true
+          // The new caching headers replace the stored ones.
+          callback({
+            statusCode: 304,
+            headers: {'Cache-Control': 'max-age=60', 'ETag': '"v1"'}
+          })
+        } else {
+          callback({
+            data: buffer,
+            headers: {'Cache-Control': 'no-cache', 'ETag': '"v1"'}
+          })
+        }
+      }
+      var url = protocolName + '://fake-host/revalidated'
+      protocol.registerBufferProtocol(protocolName, handler, {cacheSize: 1024}, function (error) {
+        if (error) return done(error)
+        $.get(url).then(function () {
+          return $.get(url)
+        }).then(function (data, status, request) {
+          assert.equal(data, text)
+          assert.equal(request.getResponseHeader('ETag'), '"v1"')
+          assert.equal(request.getResponseHeader('Cache-Control'), 'max-age=60')
+          assert(revalidated)
+          return $.get(url)
+        }).then(function (data) {
+          assert.equal(data, text)
+          assert.equal(calls, 2)
+          done()
+        }, function (xhr, errorType, error) {
+          done(error)
+        })
+      })
+    })
+
+    it('does not cache no-store responses', function (done) {
+      var calls = 0
+      var handler = function (request, callback) {
+        calls++
+        callback({
+          data: buffer,
+          headers: {'Cache-Control': 'no-store, max-age=60', 'ETag': '"v1"'}
+        })
+      }
+      var url = protocolName + '://fake-host/no-store'
+      protocol.registerBufferProtocol(protocolName, handler, {cacheSize: 1024}, function (error) {
+        if (error) return done(error)
+        $.get(url).then(function () {
+          return $.get(url)
+        }).then(function (data) {
+          assert.equal(data, text)
+          assert.equal(calls, 2)
+          done()
+        }, function (xhr, errorType, error) {
+          done(error)
+        })
+      })
+    })
+
+    it('does not cache responses with invalid caching headers', function (done) {
+      var calls = 0
+      var handler = function (request, callback) {
+        calls++
+        callback({
+          data: buffer,
+          headers: {'Cache-Control': 'max-age=60\r\nX-Injected: 1'}
+        })
+      }
+      var url = protocolName + '://fake-host/invalid-headers'
+      protocol.registerBufferProtocol(protocolName, handler, {cacheSize: 1024}, function (error) {
+        if (error) return done(error)
+        $.get(url).then(function (data, status, request) {
+          assert.equal(data, text)
+          assert.equal(request.getResponseHeader('X-Injected'), null)
+          return $.get(url)
+        }).then(function () {
+          assert.equal(calls, 2)
+          done()
+        }, function (xhr, errorType, error) {
+          done(error)
+        })
+      })
+    })
+
+    it('throws when other protocol types are given a cacheSize', function () {
+      assert.throws(function () {
+        protocol.registerHttpProtocol(protocolName, function () {}, {cacheSize: 1024})
+      }, /cacheSize is only supported by buffer and string protocols/)
+    })
+
+    it('evicts the least recently used responses beyond cacheSize', function (done) {
+      var calls = {}
+      var handler = function (request, callback) {
+        calls[request.url] = (calls[request.url] || 0) + 1
+        callback({
+          data: Buffer.alloc(100, 'a'),
+          headers: {'Cache-Control': 'max-age=60'}
+        })
+      }
+      var url = function (name) {
+        return protocolName + '://fake-host/' + name
+      }
+      // Each response takes up 130 to 170 bytes, so only two of them fit.
+      protocol.registerBufferProtocol(protocolName, handler, {cacheSize: 350}, function (error) {
+        if (error) return done(error)
+        $.get(url('a')).then(function () {
+          return $.get(url('b'))
+        }).then(function () {
+          return $.get(url('a'))
+        }).then(function () {
+          return $.get(url('c'))
+        }).then(function () {
+          return $.get(url('a'))
+        }).then(function () {
+          return $.get(url('b'))
+        }).then(function () {
+          assert.equal(calls[url('a')], 1)
+          assert.equal(calls[url('b')], 2)
+          assert.equal(calls[url('c')], 1)
+          done()
+        }, function (xhr, errorType, error) {
+          done(error)
+        })
+      })
+    })
+
     it('fails when sending string', function (done) {
       var handler = function (request, callback) {
         callback(text)
@@ -308,6 +465,167 @@ describe('protocol module', function () {
     })
   })
 
+  describe('protocol.registerStreamProtocol', function () {
+    var createStream = function (chunks) {
+      var PassThrough = remote.require('stream').PassThrough
+      var stream = new PassThrough()
+      chunks.forEach(function (chunk) {
+        stream.write(chunk)
+      })
+      stream.end()
+      return stream
+    }
+
+    it('sends stream as response', function (done) {
+      var handler = function (request, callback) {
+        callback(createStream([text.substr(0, 5), text.substr(5)]))
+      }
+      protocol.registerStreamProtocol(protocolName, handler, function (error) {
+        if (error) {
+          return done(error)
+        }
+        $.ajax({
+          url: protocolName + '://fake-host',
+          cache: false,
+          success: function (data, status, request) {
+            assert.equal(data, text)
+            assert.equal(request.getResponseHeader('Access-Control-Allow-Origin'), '*')
+            done()
+          },
+          error: function (xhr, errorType, error) {
+            done(error)
+          }
+        })
+      })
+    })
+
+    it('sends status code and headers', function (done) {
+      var handler = function (request, callback) {
+        callback({
+          statusCode: 201,
+          headers: {
+            'content-type': 'text/plain',
+            'x-custom': ['a', 'b']
+          },
+          data: createStream([text])
+        })
+      }
+      protocol.registerStreamProtocol(protocolName, handler, function (error) {
+        if (error) {
+          return done(error)
+        }
+        $.ajax({
+          url: protocolName + '://fake-host',
+          cache: false,
+          success: function (data, status, request) {
+            assert.equal(data, text)
+            assert.equal(request.status, 201)
+            assert.equal(request.getResponseHeader('x-custom'), 'a, b')
+            done()
+          },
+          error: function (xhr, errorType, error) {
+            done(error)
+          }
+        })
+      })
+    })
+
+    it('fails when a header would break the response', function (done) {
+      var handler = function (request, callback) {
+        callback({
+          headers: {'x-custom': 'a\r\nx-injected: b'},
+          data: createStream([text])
+        })
+      }
+      protocol.registerStreamProtocol(protocolName, handler, function (error) {
+        if (error) return done(error)
+        $.ajax({
+          url: protocolName + '://fake-host',
+          cache: false,
+          success: function () {
+            done('request succeeded but it should not')
+          },
+          error: function (xhr, errorType) {
+            assert.equal(errorType, 'error')
+            done()
+          }
+        })
+      })
+    })
+
+    it('pauses and resumes streams that send faster than they are read', function (done) {
+      var generated = remote.require(path.join(__dirname, 'fixtures', 'module', 'generated-stream.js'))
+      var size = 16 * 1024 * 1024
+      var handler = function (request, callback) {
+        // Bursts of 4MB go past the 1MB high water mark before it is seen.
+        callback(generated.create(size, 64))
+      }
+      protocol.registerStreamProtocol(protocolName, handler, function (error) {
+        if (error) return done(error)
+        var xhr = new XMLHttpRequest()
+        xhr.open('GET', protocolName + '://fake-host')
+        xhr.responseType = 'arraybuffer'
+        xhr.onload = function () {
+          assert.equal(xhr.response.byteLength, size)
+          var stats = generated.getStats()
+          assert.notEqual(stats.pauses, 0)
+          // Flowing streams are resumed once when they start.
+          assert(stats.resumes > 1)
+          assert.equal(stats.destroyed, false)
+          done()
+        }
+        xhr.onerror = function () {
+          done('request failed')
+        }
+        xhr.send()
+      })
+    })
+
+    it('destroys the stream when the request is aborted', function (done) {
+      var generated = remote.require(path.join(__dirname, 'fixtures', 'module', 'generated-stream.js'))
+      var handler = function (request, callback) {
+        callback(generated.create())
+      }
+      protocol.registerStreamProtocol(protocolName, handler, function (error) {
+        if (error) return done(error)
+        var xhr = new XMLHttpRequest()
+        xhr.open('GET', protocolName + '://fake-host')
+        xhr.onprogress = function () {
+          xhr.onprogress = null
+          xhr.abort()
+          var waitForDestroy = function () {
+            if (generated.getStats().destroyed) return done()
+            setTimeout(waitForDestroy, 50)
+          }
+          waitForDestroy()
+        }
+        xhr.send()
+      })
+    })
+
+    it('fails when sending string', function (done) {
+      var handler = function (request, callback) {
+        callback(text)
+      }
+      protocol.registerStreamProtocol(protocolName, handler, function (error) {
+        if (error) {
+          return done(error)
+        }
+        $.ajax({
+          url: protocolName + '://fake-host',
+          cache: false,
+          success: function () {
+            done('request succeeded but it should not')
+          },
+          error: function (xhr, errorType) {
+            assert.equal(errorType, 'error')
+            done()
+          }
+        })
+      })
+    })
+  })
+
   describe('protocol.registerFileProtocol', function () {
     var filePath = path.join(__dirname, 'fixtures', 'asar', 'a.asar', 'file1')
     var fileContent = require('fs').readFileSync(filePath)
@@ -11,6 +11,10 @@ describe('webRequest module', function () {
       res.statusCode = 301
       res.setHeader('Location', 'http://' + req.rawHeaders[1])
       res.end()
+    } else if (req.url === '/postRedirect') {
+      res.statusCode = 303
+      res.setHeader('Location', '/')
+      res.end()
     } else {
       res.setHeader('Custom', ['Header'])
       var content = req.url
@@ -34,6 +38,107 @@ describe('webRequest module', function () {
     server.close()
   })
 
+  describe('webRequest.setRules', function () {
+    afterEach(function () {
+      ses.webRequest.setRules(null)
+      ses.webRequest.onBeforeRequest(null)
+    })
+
+    it('can block requests', function (done) {
+      ses.webRequest.setRules([{action: 'block', urls: [defaultURL + 'block/*']}])
+      $.ajax({
+        url: defaultURL + 'block/test',
+        success: function () {
+          done('unexpected success')
+        },
+        error: function () {
+          done()
+        }
+      })
+    })
+
+    it('can redirect requests', function (done) {
+      ses.webRequest.setRules([
+        {action: 'redirect', urls: [defaultURL + 'old'], redirectURL: defaultURL + 'new'}
+      ])
+      $.ajax({
+        url: defaultURL + 'old',
+        success: function (data) {
+          assert.equal(data, '/new')
+          done()
+        },
+        error: function (xhr, errorType) {
+          done(errorType)
+        }
+      })
+    })
+
+    it('can set request and response headers', function (done) {
+      ses.webRequest.setRules([
+        {action: 'setRequestHeader', name: 'Accept', value: '*/*;test/header'},
+        {action: 'setResponseHeader', name: 'Custom', value: 'Rule'}
+      ])
+      $.ajax({
+        url: defaultURL,
+        success: function (data, status, xhr) {
+          assert.equal(data, '/header/received')
+          assert.equal(xhr.getResponseHeader('Custom'), 'Rule')
+          done()
+        },
+        error: function (xhr, errorType) {
+          done(errorType)
+        }
+      })
+    })
+
+    it('does not call the listener for requests handled by a rule', function (done) {
+      ses.webRequest.setRules([{action: 'block', urls: [defaultURL + 'block/*']}])
+      ses.webRequest.onBeforeRequest(function (details, callback) {
+        assert.equal(details.url, defaultURL + 'pass')
+        callback({})
+      })
+      $.ajax({
+        url: defaultURL + 'block/test',
+        success: function () {
+          done('unexpected success')
+        },
+        error: function () {
+          $.ajax({
+            url: defaultURL + 'pass',
+            success: function (data) {
+              assert.equal(data, '/pass')
+              done()
+            },
+            error: function (xhr, errorType) {
+              done(errorType)
+            }
+          })
+        }
+      })
+    })
+
+    it('throws on invalid rules', function () {
+      assert.throws(function () {
+        ses.webRequest.setRules([{action: 'explode'}])
+      }, /Invalid rule at index 0: Unknown action: explode/)
+      assert.throws(function () {
+        ses.webRequest.setRules([{action: 'redirect'}])
+      }, /redirectURL must be a valid URL/)
+      assert.throws(function () {
+        ses.webRequest.setRules([{action: 'removeRequestHeader'}])
+      }, /name must be a valid header name/)
+      assert.throws(function () {
+        ses.webRequest.setRules([{action: 'setRequestHeader', name: 'X-Bad\r\nInjected', value: '1'}])
+      }, /name must be a valid header name/)
+      assert.throws(function () {
+        ses.webRequest.setRules([{action: 'setRequestHeader', name: 'X-Test', value: 'x\r\nInjected: 1'}])
+      }, /value must be a valid header value/)
+      assert.throws(function () {
+        ses.webRequest.setRules([{action: 'setResponseHeader', name: 'X-Test', value: 'x\0y'}])
+      }, /value must be a valid header value/)
+    })
+  })
+
   describe('webRequest.onBeforeRequest', function () {
     afterEach(function () {
       ses.webRequest.onBeforeRequest(null)
@@ -85,6 +190,37 @@ describe('webRequest module', function () {
       })
     })
 
+    it('can filter URLs with many patterns', function (done) {
+      var urls = []
+      for (var i = 0; i < 100; i++) {
+        urls.push('*://*.host' + i + '.com/*', 'http://*/path' + i + '/*')
+      }
+      urls.push('http://*/*/filtered-*.js')
+      ses.webRequest.onBeforeRequest({urls: urls}, function (details, callback) {
+        callback({
+          cancel: true
+        })
+      })
+      $.ajax({
+        url: defaultURL + 'path/unfiltered-1.js',
+        success: function (data) {
+          assert.equal(data, '/path/unfiltered-1.js')
+          $.ajax({
+            url: defaultURL + 'path/filtered-1.js',
+            success: function () {
+              done('unexpected success')
+            },
+            error: function () {
+              done()
+            }
+          })
+        },
+        error: function (xhr, errorType) {
+          done(errorType)
+        }
+      })
+    })
+
     it('receives details object', function (done) {
       ses.webRequest.onBeforeRequest(function (details, callback) {
         assert.equal(typeof details.id, 'number')
@@ -133,6 +269,53 @@ describe('webRequest module', function () {
       })
     })
 
+    it('drops the post data after a redirect to a GET request', function (done) {
+      ses.webRequest.onBeforeRequest(function (details, callback) {
+        if (details.method === 'POST') {
+          assert.equal(details.uploadData.length, 1)
+          callback({})
+        } else {
+          assert.equal(details.url, defaultURL)
+          assert(!details.uploadData)
+          callback({cancel: true})
+        }
+      })
+      $.ajax({
+        url: defaultURL + 'postRedirect',
+        type: 'POST',
+        data: {name: 'post test'},
+        success: function () {},
+        error: function () {
+          done()
+        }
+      })
+    })
+
+    it('only passes the details fields asked for', function (done) {
+      ses.webRequest.onBeforeRequest({fields: []}, function (details, callback) {
+        assert.equal(details.method, 'POST')
+        assert(!details.uploadData)
+        callback({
+          cancel: true
+        })
+      })
+      $.ajax({
+        url: defaultURL,
+        type: 'POST',
+        data: {name: 'post test'},
+        success: function () {},
+        error: function () {
+          done()
+        }
+      })
+    })
+
+    it('throws on unknown details fields', function () {
+      assert.throws(function () {
+        ses.webRequest.onBeforeRequest({fields: ['body']}, function () {})
+      }, /Unknown details field: body/)
+    })
+
     it('can redirect the request', function (done) {
       ses.webRequest.onBeforeRequest(function (details, callback) {
         if (details.url === defaultURL) {
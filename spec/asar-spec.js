@@ -37,6 +37,14 @@ describe('asar package', function () {
         assert.equal(fs.readFileSync(file3).toString().trim(), 'file3')
       })
 
+      it('returns a buffer that can be modified', function () {
+        var file1 = path.join(fixtures, 'asar', 'a.asar', 'file1')
+        var buffer = fs.readFileSync(file1)
+        buffer[0] = 'F'.charCodeAt(0)
+        assert.equal(buffer.toString().trim(), 'File1')
+        assert.equal(fs.readFileSync(file1).toString().trim(), 'file1')
+      })
+
       it('reads from a empty file', function () {
         var file = path.join(fixtures, 'asar', 'empty.asar', 'file1')
         var buffer = fs.readFileSync(file)
@@ -688,6 +696,81 @@ describe('asar package', function () {
       })
     })
 
+    describe('binary header', function () {
+      it('reads a normal file', function () {
+        var file1 = path.join(fixtures, 'asar', 'indexed.asar', 'file1')
+        assert.equal(fs.readFileSync(file1).toString().trim(), 'file1')
+        var file2 = path.join(fixtures, 'asar', 'indexed.asar', 'dir2', 'file2')
+        assert.equal(fs.readFileSync(file2).toString().trim(), 'file2')
+      })
+
+      it('reads a file from linked directory', function () {
+        var p = path.join(fixtures, 'asar', 'indexed.asar', 'link2', 'link2', 'file1')
+        assert.equal(fs.readFileSync(p).toString().trim(), 'file1')
+      })
+
+      it('reads dirs from root', function () {
+        var p = path.join(fixtures, 'asar', 'indexed.asar')
+        var dirs = fs.readdirSync(p)
+        assert.deepEqual(dirs, ['dir1', 'dir2', 'dir3', 'file1', 'file2', 'file3', 'link1', 'link2', 'ping.js'])
+      })
+
+      it('returns information of files, directories and links', function () {
+        var stats = fs.lstatSync(path.join(fixtures, 'asar', 'indexed.asar', 'dir1', 'file1'))
+        assert.equal(stats.isFile(), true)
+        assert.equal(stats.size, 6)
+        stats = fs.lstatSync(path.join(fixtures, 'asar', 'indexed.asar', 'dir1'))
+        assert.equal(stats.isDirectory(), true)
+        stats = fs.lstatSync(path.join(fixtures, 'asar', 'indexed.asar', 'link1'))
+        assert.equal(stats.isSymbolicLink(), true)
+      })
+
+      it('throws ENOENT error when can not find file', function () {
+        var p = path.join(fixtures, 'asar', 'indexed.asar', 'not-exist')
+        assert.throws(function () {
+          fs.readFileSync(p)
+        }, /ENOENT/)
+      })
+    })
+
+    describe('compressed files', function () {
+      var lorem = 'Lorem ipsum dolor sit amet, consectetur adipiscing elit.\n'
+
+      it('reads a compressed file synchronously', function () {
+        var p = path.join(fixtures, 'asar', 'compressed.asar', 'lorem.txt')
+        assert.equal(fs.readFileSync(p, 'utf8'), lorem.repeat(64))
+        assert.equal(fs.readFileSync(p).length, lorem.length * 64)
+      })
+
+      it('reads a compressed file asynchronously', function (done) {
+        var p = path.join(fixtures, 'asar', 'compressed.asar', 'lorem.txt')
+        fs.readFile(p, 'utf8', function (err, content) {
+          assert.equal(err, null)
+          assert.equal(content, lorem.repeat(64))
+          done()
+        })
+      })
+
+      it('reports the uncompressed size', function () {
+        var p = path.join(fixtures, 'asar', 'compressed.asar', 'lorem.txt')
+        assert.equal(fs.lstatSync(p).size, lorem.length * 64)
+      })
+
+      it('requires a compressed module', function () {
+        var p = path.join(fixtures, 'asar', 'compressed.asar', 'index.js')
+        assert.equal(require(p).text, 'compressed module '.repeat(32))
+      })
+
+      it('copies out a compressed file', function () {
+        var p = path.join(fixtures, 'asar', 'compressed.asar', 'lorem.txt')
+        var fd = fs.openSync(p, 'r')
+        var buffer = new Buffer(lorem.length)
+        fs.readSync(fd, buffer, 0, lorem.length, 0)
+        fs.closeSync(fd)
+        assert.equal(buffer.toString(), lorem)
+      })
+    })
+
     describe('process.noAsar', function () {
       var errorName = process.platform === 'win32' ? 'ENOENT' : 'ENOTDIR'
 
@@ -822,6 +905,57 @@ describe('asar package', function () {
       })
     })
 
+    it('can request a compressed file in package', function (done) {
+      var p = path.resolve(fixtures, 'asar', 'compressed.asar', 'index.html')
+      $.get('file://' + p, function (data) {
+        assert.equal(data.trim(), '<html><body>' + 'compressed page '.repeat(32) + '</body></html>')
+        done()
+      })
+    })
+
+    it('can request a range of a file in package', function (done) {
+      var p = path.resolve(fixtures, 'asar', 'a.asar', 'file1')
+      $.ajax({
+        url: 'file://' + p,
+        headers: {Range: 'bytes=1-3'},
+        success: function (data, status, xhr) {
+          assert.equal(xhr.status, 206)
+          assert.equal(data, 'ile')
+          assert.equal(xhr.getResponseHeader('Content-Range'), 'bytes 1-3/6')
+          done()
+        }
+      })
+    })
+
+    it('responds 416 to an unsatisfiable range of a file in package', function (done) {
+      var p = path.resolve(fixtures, 'asar', 'a.asar', 'file1')
+      $.ajax({
+        url: 'file://' + p,
+        headers: {Range: 'bytes=10-20'},
+        complete: function (xhr) {
+          assert.equal(xhr.status, 416)
+          assert.equal(xhr.getResponseHeader('Content-Range'), 'bytes */6')
+          done()
+        }
+      })
+    })
+
+    it('responds to conditional requests of a file in package', function (done) {
+      var p = path.resolve(fixtures, 'asar', 'a.asar', 'file1')
+      $.get('file://' + p, function (data, status, xhr) {
+        var etag = xhr.getResponseHeader('ETag')
+        assert.ok(etag)
+        $.ajax({
+          url: 'file://' + p,
+          headers: {'If-None-Match': etag},
+          complete: function (xhr) {
+            assert.equal(xhr.status, 304)
+            done()
+          }
+        })
+      })
+    })
+
     it('can request a file in filesystem', function (done) {
       var p = path.resolve(fixtures, 'asar', 'file')
       $.get('file://' + p, function (data) {
@@ -0,0 +1,40 @@
+const {Readable} = require('stream')
+
+const chunk = Buffer.alloc(64 * 1024, 'a')
+
+// Records what happened to the last created stream.
+exports.stats = null
+
+// Creates a stream generating |size| bytes, or endless data without a size,
+// in bursts of |burst| chunks.
+exports.create = function (size, burst = 1) {
+  const stats = exports.stats = {
+    generated: 0,
+    pauses: 0,
+    resumes: 0,
+    destroyed: false
+  }
+
+  const stream = new Readable({
+    read () {
+      setImmediate(() => {
+        for (let i = 0; i < burst && !stats.destroyed; i++) {
+          if (size !== undefined && stats.generated >= size) {
+            this.push(null)
+            return
+          }
+          stats.generated += chunk.length
+          this.push(chunk)
+        }
+      })
+    }
+  })
+  stream.on('pause', () => { stats.pauses++ })
+  stream.on('resume', () => { stats.resumes++ })
+  stream.destroy = () => { stats.destroyed = true }
+  return stream
+}
+
+exports.getStats = function () {
+  return exports.stats
+}
@@ -0,0 +1,4 @@
+self.onmessage = function (event) {
+  require('fs').readFileSync(event.data)
+  self.postMessage('read')
+}
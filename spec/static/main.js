@@ -41,6 +41,33 @@ ipcMain.on('message', function (event, ...args) {
   event.sender.send('message', ...args)
 })
 
+// Echoed on the 'message' channel, for mixing with batched messages.
+ipcMain.on('message-unbatched', function (event, ...args) {
+  event.sender.send('message', ...args)
+})
+
+ipcMain.handle('invoke-add', function (event, a, b) {
+  return a + b
+})
+
+ipcMain.handle('invoke-throw', function (event, message) {
+  throw new Error(message)
+})
+
+ipcMain.handle('invoke-buffer', function (event, text) {
+  return Promise.resolve(Buffer.from(text))
+})
+
+ipcMain.handle('invoke-echo', function (event, value) {
+  return value
+})
+
+ipcMain.on('describe-values', function (event, ...args) {
+  event.sender.send('describe-values', args.map(function (arg) {
+    return Object.prototype.toString.call(arg)
+  }))
+})
+
 // Set productName so getUploadedReports() uses the right directory in specs
 if (process.platform !== 'darwin') {
   crashReporter.productName = 'Zombies'
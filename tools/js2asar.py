@@ -1,26 +1,62 @@
 #!/usr/bin/env python
 
+import argparse
 import errno
 import os
+import re
 import shutil
+import stat
+import struct
 import subprocess
 import sys
 import tempfile
+import zlib
 
 SOURCE_ROOT = os.path.dirname(os.path.dirname(__file__))
 
+# Keep in sync with atom/common/asar/archive_index.h.
+INDEX_MAGIC = b'ASARIDX\0'
+INDEX_VERSION = 2
+INDEX_HEADER_FORMAT = '<8s8I'
+INDEX_NODE_FORMAT = '<Q6I'
+INDEX_PATH_FORMAT = '<3I'
+FLAG_DIRECTORY = 1 << 0
+FLAG_LINK = 1 << 1
+FLAG_EXECUTABLE = 1 << 3
+FLAG_COMPRESSED = 1 << 4
+
 
 def main():
-  archive = sys.argv[1]
-  folder_name = sys.argv[2]
-  source_files = sys.argv[3:]
+  args = parse_args()
 
   output_dir = tempfile.mkdtemp()
-  copy_files(source_files, output_dir)
-  call_asar(archive, os.path.join(output_dir, folder_name))
+  copy_files(args.source_files, output_dir)
+  if args.binary_header:
+    write_indexed_asar(args.archive, os.path.join(output_dir, args.folder_name),
+                       args.compress, args.order)
+  else:
+    call_asar(args.archive, os.path.join(output_dir, args.folder_name),
+              args.order)
+  if args.order:
+    write_prefetch_manifest(args.archive, args.order)
   shutil.rmtree(output_dir)
 
 
+def parse_args():
+  parser = argparse.ArgumentParser(description='Pack files into asar archive')
+  parser.add_argument('--binary-header', action='store_true',
+                      help='Write the binary header instead of the JSON one')
+  parser.add_argument('--compress', action='store_true',
+                      help='Compress files, requires --binary-header')
+  parser.add_argument('--order',
+                      help='Access-order manifest, or the log written by '
+                           'ELECTRON_LOG_ASAR_READS, to lay out files by')
+  parser.add_argument('archive')
+  parser.add_argument('folder_name')
+  parser.add_argument('source_files', nargs='*')
+  return parser.parse_args()
+
+
 def copy_files(source_files, output_dir):
   for source_file in source_files:
     output_path = os.path.join(output_dir, source_file)
@@ -28,11 +64,163 @@ def copy_files(source_files, output_dir):
     shutil.copy2(source_file, output_path)
 
 
-def call_asar(archive, output_dir):
+def call_asar(archive, output_dir, order=None):
   asar = os.path.join(SOURCE_ROOT, 'node_modules', '.bin', 'asar')
   if sys.platform in ['win32', 'cygwin']:
     asar += '.cmd'
-  subprocess.check_call([asar, 'pack', output_dir, archive])
+  command = [asar, 'pack', output_dir, archive]
+  if order:
+    command += ['--ordering', order]
+  subprocess.check_call(command)
+
+
+def read_order(order):
+  # Accept both plain paths and the "offset: path" lines written by
+  # ELECTRON_LOG_ASAR_READS, keeping only the first access of each file.
+  paths = []
+  seen = set()
+  with open(order, 'r') as f:
+    for line in f:
+      path = re.sub(r'^\d+: ', '', line.strip()).replace('\\', '/')
+      if path and path not in seen:
+        seen.add(path)
+        paths.append(path)
+  return paths
+
+
+def write_prefetch_manifest(archive, order):
+  # Electron prefetches the listed files when opening the archive.
+  with open(archive + '.prefetch', 'w') as f:
+    for path in read_order(order):
+      f.write(path + '\n')
+
+
+def write_indexed_asar(archive, output_dir, compress=False, order=None):
+  root = read_tree(output_dir, output_dir)
+
+  # Lay out nodes so children of each directory are contiguous and sorted.
+  nodes = [root]
+  queue = [root]
+  while queue:
+    node = queue.pop(0)
+    if node['type'] != 'directory':
+      continue
+    node['first'] = len(nodes)
+    node['count'] = len(node['children'])
+    for child in node['children']:
+      nodes.append(child)
+      queue.append(child)
+
+  strings = bytearray()
+
+  def add_string(value):
+    offset = len(strings)
+    strings.extend(value)
+    return offset, len(value)
+
+  for node in nodes:
+    node['name_ref'] = add_string(node['name'])
+    if node['type'] == 'file' and compress:
+      compress_file(node)
+    elif node['type'] == 'link':
+      node['first'], node['count'] = add_string(node['link'])
+
+  # Put files in the access order first so they are read sequentially.
+  files = [node for node in nodes if node['type'] == 'file']
+  if order:
+    rank = dict((encode_path(path), index)
+                for index, path in enumerate(read_order(order)))
+    files.sort(key=lambda node: rank.get(node['path'], len(rank)))
+
+  data_offset = 0
+  for node in files:
+    node['offset'] = data_offset
+    data_offset += node.get('count', node['size'])
+
+  paths = sorted((node['path'], index) for index, node in enumerate(nodes)
+                 if index != 0)
+  path_refs = [(add_string(path), index) for path, index in paths]
+
+  header_size = struct.calcsize(INDEX_HEADER_FORMAT)
+  nodes_offset = header_size
+  paths_offset = nodes_offset + len(nodes) * struct.calcsize(INDEX_NODE_FORMAT)
+  strings_offset = paths_offset + len(paths) * struct.calcsize(
+      INDEX_PATH_FORMAT)
+
+  # Archives without compressed files stay readable by version 1 readers.
+  version = INDEX_VERSION if any(node['flags'] & FLAG_COMPRESSED
+                                 for node in nodes) else 1
+  index = bytearray(struct.pack(INDEX_HEADER_FORMAT, INDEX_MAGIC,
+                                version, len(nodes), nodes_offset,
+                                len(paths), paths_offset, strings_offset,
+                                len(strings), 0))
+  for node in nodes:
+    index.extend(struct.pack(INDEX_NODE_FORMAT, node.get('offset', 0),
+                             node.get('size', 0), node['flags'],
+                             node['name_ref'][0], node['name_ref'][1],
+                             node.get('first', 0), node.get('count', 0)))
+  for (path, path_size), node in path_refs:
+    index.extend(struct.pack(INDEX_PATH_FORMAT, path, path_size, node))
+  index.extend(strings)
+  # Keep file data aligned.
+  index.extend(b'\0' * (-len(index) % 8))
+
+  with open(archive, 'wb') as f:
+    f.write(struct.pack('<II', 4, len(index)))
+    f.write(index)
+    for node in files:
+      if 'data' in node:
+        f.write(node['data'])
+      else:
+        with open(node['real_path'], 'rb') as source:
+          shutil.copyfileobj(source, f)
+
+
+def compress_file(node):
+  with open(node['real_path'], 'rb') as source:
+    data = zlib.compress(source.read(), 9)
+  # Only keep the compressed data when it actually saves space.
+  if len(data) < node['size']:
+    node['flags'] |= FLAG_COMPRESSED
+    node['data'] = data
+    node['count'] = len(data)
+
+
+def read_tree(root_dir, path):
+  relative = os.path.relpath(path, root_dir).replace(os.sep, '/')
+  if relative == '.':
+    relative = ''
+  node = {
+    'name': encode_path(os.path.basename(relative)),
+    'path': encode_path(relative),
+    'flags': 0,
+  }
+
+  if os.path.islink(path):
+    target = os.path.realpath(path)
+    link = os.path.relpath(target, os.path.realpath(root_dir))
+    node['type'] = 'link'
+    node['flags'] = FLAG_LINK
+    node['link'] = encode_path(link.replace(os.sep, '/'))
+  elif os.path.isdir(path):
+    node['type'] = 'directory'
+    node['flags'] = FLAG_DIRECTORY
+    children = [read_tree(root_dir, os.path.join(path, name))
+                for name in os.listdir(path)]
+    node['children'] = sorted(children, key=lambda child: child['name'])
+  else:
+    node['type'] = 'file'
+    node['real_path'] = path
+    node['size'] = os.path.getsize(path)
+    if os.stat(path).st_mode & stat.S_IXUSR:
+      node['flags'] = FLAG_EXECUTABLE
+  return node
+
+
+def encode_path(path):
+  if isinstance(path, bytes):
+    return path
+  return path.encode('utf-8')
 
 
 def safe_mkdir(path):